@@ -0,0 +1,181 @@
+// DOGM::updateGrid의 steady-state 힙 할당 검사.
+// 전역 operator new를 교체해 updateGrid 호출 동안의 할당 횟수와 바이트를 세고, 첫 프레임(warm-up)
+// 이후 한 번이라도 할당한 설정이 있으면 종료 코드 1을 돌려준다. C++ 할당만 센다 (OpenMP 런타임의
+// malloc은 포함하지 않는다).
+//
+// 사용법: dogm_alloc_check [grid_cells_per_side=200] [particles=50000] [frames=20]
+#include "bench_scene.h"
+#include <atomic>
+#include <cstdlib>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <new>
+#include <string>
+#include <vector>
+
+namespace {
+
+std::atomic<bool> g_counting{false};
+std::atomic<long long> g_allocations{0};
+std::atomic<long long> g_bytes{0};
+
+void* countedAlloc(std::size_t size, std::size_t alignment) {
+    if (g_counting.load(std::memory_order_relaxed)) {
+        g_allocations.fetch_add(1, std::memory_order_relaxed);
+        g_bytes.fetch_add(static_cast<long long>(size), std::memory_order_relaxed);
+    }
+    if (size == 0) size = 1;
+    void* p = nullptr;
+    if (alignment <= alignof(std::max_align_t)) {
+        p = std::malloc(size);
+    } else {
+        // aligned_alloc은 크기가 alignment의 배수여야 한다
+        p = std::aligned_alloc(alignment, (size + alignment - 1) / alignment * alignment);
+    }
+    if (!p) throw std::bad_alloc();
+    return p;
+}
+
+} // namespace
+
+void* operator new(std::size_t size) { return countedAlloc(size, 0); }
+void* operator new[](std::size_t size) { return countedAlloc(size, 0); }
+void* operator new(std::size_t size, std::align_val_t align) {
+    return countedAlloc(size, static_cast<std::size_t>(align));
+}
+void* operator new[](std::size_t size, std::align_val_t align) {
+    return countedAlloc(size, static_cast<std::size_t>(align));
+}
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+    try { return countedAlloc(size, 0); } catch (...) { return nullptr; }
+}
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept {
+    try { return countedAlloc(size, 0); } catch (...) { return nullptr; }
+}
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t) noexcept { std::free(p); }
+void operator delete(void* p, std::align_val_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::align_val_t) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t, std::align_val_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t, std::align_val_t) noexcept { std::free(p); }
+
+using namespace dogm;
+using namespace dogm::bench;
+
+namespace {
+
+struct Scenario {
+    std::string name;
+    std::function<void(DOGM::Params&)> configure;
+    bool moving_ego = false;   // follow_ego에서 창 이동(clearEnteringCells, shiftParticles)을 거치도록
+};
+
+struct AllocationCount {
+    long long warmup = 0;      // 첫 프레임
+    long long steady = 0;      // 이후 프레임 합
+    long long steady_bytes = 0;
+};
+
+AllocationCount runScenario(const Scenario& scenario, const SceneConfig& config, int frames) {
+    DOGM::Params params = sceneParams(config);
+    params.stats_histogram_window = 64;
+    scenario.configure(params);
+
+    // 프레임 생성은 측정 밖에서 미리 한다
+    const std::vector<SensorFrame> inputs = scenario.moving_ego ? makeMovingEgoFrames(config, params.size, frames)
+                                                                : makeSyntheticFrames(config, params.size, frames);
+
+    DOGM dogm(params);
+    AllocationCount count;
+    for (int f = 0; f < frames; ++f) {
+        const long long before = g_allocations.load();
+        const long long before_bytes = g_bytes.load();
+        g_counting.store(true);
+        dogm.updateGrid(inputs[f], 0.1f);
+        g_counting.store(false);
+        const long long allocations = g_allocations.load() - before;
+        if (f == 0) {
+            count.warmup = allocations;
+        } else {
+            count.steady += allocations;
+            count.steady_bytes += g_bytes.load() - before_bytes;
+        }
+    }
+    return count;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    SceneConfig config;
+    config.grid_cells_per_side = (argc > 1) ? std::atoi(argv[1]) : 200;
+    config.particle_count = (argc > 2) ? std::atoi(argv[2]) : 50000;
+    config.beam_count = 720;
+    config.radar_count = 200;
+    const int frames = std::max((argc > 3) ? std::atoi(argv[3]) : 20, 2);
+
+    auto adaptive = [](ParticleCountCriterion criterion) {
+        return [criterion](DOGM::Params& p) {
+            p.adaptive_particle_count = true;
+            p.particle_count_criterion = criterion;
+            p.min_particle_count = p.particle_count / 4;
+            p.max_particle_count = p.particle_count * 2;
+        };
+    };
+    auto resampling = [](ResamplingMethod method) {
+        return [method](DOGM::Params& p) { p.resampling_method = method; };
+    };
+
+    const std::vector<Scenario> scenarios = {
+        {"sparse", [](DOGM::Params&) {}},
+        {"dense", [](DOGM::Params& p) { p.sparse_cells = false; }},
+        {"staged", [](DOGM::Params& p) { p.fused_cell_update = false; }},
+        {"systematic", resampling(ResamplingMethod::Systematic)},
+        {"stratified", resampling(ResamplingMethod::Stratified)},
+        {"residual", resampling(ResamplingMethod::Residual)},
+        {"parallel_systematic", resampling(ResamplingMethod::ParallelSystematic)},
+        {"adaptive/ess", adaptive(ParticleCountCriterion::EffectiveSampleSize)},
+        {"adaptive/occupied", adaptive(ParticleCountCriterion::OccupiedCells)},
+        {"adaptive/kld", adaptive(ParticleCountCriterion::KLD)},
+        {"follow_ego", [](DOGM::Params& p) { p.follow_ego = true; }, true},
+        {"tiled", [](DOGM::Params& p) { p.grid_layout = GridLayout::Tiled; }},
+        {"morton", [](DOGM::Params& p) { p.grid_layout = GridLayout::Morton; }},
+        {"compact", [](DOGM::Params& p) { p.compact_particle_state = true; }},
+        {"compact/adaptive_kld", [adaptive](DOGM::Params& p) {
+            adaptive(ParticleCountCriterion::KLD)(p);
+            p.compact_particle_state = true;
+        }},
+        {"compact/follow_ego", [](DOGM::Params& p) {
+            p.compact_particle_state = true;
+            p.follow_ego = true;
+        }, true},
+        {"follow_ego/inner_size", [](DOGM::Params& p) {
+            p.follow_ego = true;
+            p.inner_size = 0.5f * p.size;
+        }, true},
+    };
+
+    std::cout << "grid " << config.grid_cells_per_side << "x" << config.grid_cells_per_side
+              << ", particles " << config.particle_count << ", frames " << frames
+              << ", threads " << omp_get_max_threads() << std::endl << std::endl;
+    std::cout << std::left << std::setw(22) << "scenario" << std::right << std::setw(14) << "first frame"
+              << std::setw(16) << "after first" << std::setw(14) << "bytes" << std::endl;
+
+    int failures = 0;
+    for (const Scenario& scenario : scenarios) {
+        AllocationCount count = runScenario(scenario, config, frames);
+        const bool ok = count.steady == 0;
+        failures += !ok;
+        std::cout << std::left << std::setw(22) << scenario.name << std::right << std::setw(14) << count.warmup
+                  << std::setw(16) << count.steady << std::setw(14) << count.steady_bytes
+                  << (ok ? "" : "  FAIL") << std::endl;
+    }
+
+    std::cout << std::endl << (failures == 0 ? "OK: no allocations after the first frame"
+                                             : "FAIL: " + std::to_string(failures) + " scenario(s) allocated")
+              << std::endl;
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,85 @@
+// 여러 그리드의 처리량 비교: 그리드별 updateGrid를 차례로 호출 (커널마다 parallel 영역)
+// vs DOGMBatch (그리드 단계를 공유 스레드 팀의 task로 실행). 두 방식의 결과가 같은지도 확인한다.
+//
+// 사용법: dogm_batch_bench [grid_cells_per_side=200] [particles=50000] [frames=10] [grids=1,2,4,8]
+#include "bench_scene.h"
+#include "bench_util.h"
+#include "dogm/dogm_batch.h"
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+using namespace dogm;
+using namespace dogm::bench;
+
+namespace {
+
+// 그리드마다 다른 파라미터 (A/B 튜닝처럼 seed와 잡음을 바꾼다)
+DOGM::Params gridParams(const SceneConfig& config, int index) {
+    DOGM::Params params = sceneParams(config);
+    params.random_seed = 1000 + index;
+    params.stddev_process_noise_velocity = 0.4f + 0.05f * (index % 4);
+    return params;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    SceneConfig config;
+    config.grid_cells_per_side = (argc > 1) ? std::atoi(argv[1]) : 200;
+    config.particle_count = (argc > 2) ? std::atoi(argv[2]) : 50000;
+    config.beam_count = 720;
+    config.radar_count = 200;
+    const int frames = (argc > 3) ? std::atoi(argv[3]) : 10;
+    const std::vector<int> grid_counts = (argc > 4) ? parseIntList(argv[4]) : std::vector<int>{1, 2, 4, 8};
+    const float dt = 0.1f;
+
+    const std::vector<SensorFrame> inputs =
+        makeSyntheticFrames(config, config.grid_cells_per_side * config.resolution, frames);
+
+    std::cout << "grid " << config.grid_cells_per_side << "x" << config.grid_cells_per_side
+              << ", particles " << config.particle_count << ", frames " << frames
+              << ", threads " << omp_get_max_threads() << std::endl << std::endl;
+    std::cout << std::setw(6) << "grids" << std::setw(16) << "sequential ms" << std::setw(12) << "batch ms"
+              << std::setw(16) << "grid-frames/s" << std::setw(10) << "speedup" << std::setw(10) << "match"
+              << std::endl;
+
+    for (int count : grid_counts) {
+        std::vector<std::unique_ptr<DOGM>> sequential;
+        DOGMBatch batch;
+        for (int i = 0; i < count; ++i) {
+            sequential.push_back(std::make_unique<DOGM>(gridParams(config, i)));
+            batch.addGrid(gridParams(config, i));
+        }
+
+        // 첫 프레임은 warm-up
+        for (auto& grid : sequential) grid->updateGrid(inputs[0], dt);
+        batch.updateGrids(SensorFrameView(inputs[0]), dt);
+
+        auto start = std::chrono::steady_clock::now();
+        for (int f = 1; f < frames; ++f) {
+            for (auto& grid : sequential) grid->updateGrid(inputs[f], dt);
+        }
+        auto mid = std::chrono::steady_clock::now();
+        for (int f = 1; f < frames; ++f) {
+            batch.updateGrids(SensorFrameView(inputs[f]), dt);
+        }
+        auto end = std::chrono::steady_clock::now();
+
+        bool match = true;
+        for (int i = 0; i < count; ++i) {
+            match = match && gridChecksum(*sequential[i]) == gridChecksum(batch.grid(i)) &&
+                    sequential[i]->getParticleCount() == batch.grid(i).getParticleCount();
+        }
+
+        const int timed = std::max(frames - 1, 1);
+        const double sequential_ms = std::chrono::duration<double, std::milli>(mid - start).count() / timed;
+        const double batch_ms = std::chrono::duration<double, std::milli>(end - mid).count() / timed;
+        std::cout << std::setw(6) << count << std::fixed << std::setprecision(2) << std::setw(16) << sequential_ms
+                  << std::setw(12) << batch_ms << std::setprecision(1) << std::setw(16) << count * 1000.0 / batch_ms
+                  << std::setprecision(2) << std::setw(9) << sequential_ms / batch_ms << "x"
+                  << std::setw(10) << (match ? "yes" : "NO") << std::endl;
+    }
+    return 0;
+}
@@ -0,0 +1,209 @@
+#pragma once
+
+// dogm_bench용 합성 장면: 그리드 크기, 파티클 수, Lidar 빔 수, Radar 탐지 수로 파라미터화된다.
+// 각 커널의 입력 스냅샷을 보관하여 커널을 개별적으로 반복 실행할 수 있다.
+
+#include "dogm/dogm.h"
+#include "dogm/kernel/init.h"
+#include "dogm/kernel/predict.h"
+#include "dogm/kernel/ray_casting.h"
+#include "dogm/kernel/resampling.h"
+#include "dogm/kernel/sensor_fusion.h"
+#include "dogm/kernel/update.h"
+#include "dogm/kernel/workspace.h"
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <vector>
+
+namespace dogm {
+namespace bench {
+
+struct SceneConfig {
+    int grid_cells_per_side = 400;   // 0.1 m 해상도 기준 40 m
+    int particle_count = 200000;
+    int beam_count = 1080;
+    int radar_count = 500;
+    float resolution = 0.1f;
+    GridLayout layout = GridLayout::RowMajor;
+};
+
+struct KernelScene {
+    SceneConfig config;
+    DOGM::Params params;
+    int grid_size = 0;
+    int cell_count = 0;
+    GridWindow window;
+    float dt = 0.1f;
+
+    SensorFrame frame;
+    RandomGenerator rng{42};
+
+    std::vector<MeasurementCell> meas_cells;
+    std::vector<GridCell> grid_cells;
+    std::vector<GridCellMoments> grid_moments;
+    std::vector<float> weight_array;
+    std::vector<float> born_masses_array;
+    std::vector<float> sparse_born_masses;   // active_cells.list 순서
+    std::vector<float> birth_weight_array;
+
+    ParticlesSoA particles;        // 셀 순으로 정렬된 predict 이후 파티클
+    ParticlesSoA particles_next;
+    ParticlesSoA birth_particles;
+    ParticlesSoA work;             // 커널이 입력을 바꾸는 경우의 작업 버퍼
+
+    // 커널별 입력 스냅샷
+    ParticlesSoA before_predict;
+    ParticlesSoA unsorted;
+    std::vector<GridCell> cells_before_occupancy;
+    std::vector<float> weights_before_persistent;
+    std::vector<float> scan_input;       // resampling의 joint weight [persistent | birth]
+    std::vector<float> scan_output;
+
+    kernel::Workspace workspace;   // scratch
+
+    ActiveCells measured_cells;
+    ActiveCells particle_cells;
+    ActiveCells active_cells;
+
+    std::unique_ptr<DOGM> dogm;
+    std::unique_ptr<DOGM> dogm_dense;  // sparse_cells = false
+};
+
+inline SensorFrame makeSyntheticFrame(const SceneConfig& config, float size, int frame_index) {
+    SensorFrame frame;
+    frame.timestamp = frame_index * 0.1;
+    frame.ego_pose = Vec2(size * 0.5f, size * 0.5f);
+    frame.ego_yaw = 0.0f;
+
+    const float max_range = size * 0.45f;
+    RandomGenerator rng(7);
+    rng.setFrame(frame_index);
+    for (int b = 0; b < config.beam_count; ++b) {
+        float angle = -static_cast<float>(M_PI) + 2.0f * static_cast<float>(M_PI) * b / config.beam_count;
+        float range = max_range * (0.55f + 0.35f * std::sin(3.0f * angle + 0.1f * frame_index));
+        frame.lidar.angles.push_back(angle);
+        frame.lidar.ranges.push_back(range);
+    }
+    for (int r = 0; r < config.radar_count; ++r) {
+        float u[4];
+        rng.uniform4(RandomStream::InitParticles, r, u);
+        float angle = -static_cast<float>(M_PI) + 2.0f * static_cast<float>(M_PI) * u[0];
+        float range = max_range * (0.2f + 0.7f * u[1]);
+        RadarDetection detection;
+        // Radar 좌표는 그리드 원점 기준 (fuseAndCreateMeasurementGrid와 동일)
+        detection.position = frame.ego_pose + range * Vec2(std::cos(angle), std::sin(angle));
+        detection.radial_velocity = -3.0f + 6.0f * u[2];
+        detection.snr = 5.0f + 25.0f * u[3];
+        frame.radar.push_back(detection);
+    }
+    return frame;
+}
+
+// frame_index 1부터 frame_count개의 합성 프레임
+inline std::vector<SensorFrame> makeSyntheticFrames(const SceneConfig& config, float size, int frame_count) {
+    std::vector<SensorFrame> frames;
+    for (int f = 0; f < frame_count; ++f) frames.push_back(makeSyntheticFrame(config, size, f + 1));
+    return frames;
+}
+
+// makeSyntheticFrames와 같지만 follow_ego 창이 매 프레임 몇 셀씩 이동하도록 ego를 움직인다
+// (clearEnteringCells, shiftParticles를 거치도록)
+inline std::vector<SensorFrame> makeMovingEgoFrames(const SceneConfig& config, float size, int frame_count) {
+    std::vector<SensorFrame> frames = makeSyntheticFrames(config, size, frame_count);
+    for (int f = 0; f < frame_count; ++f) {
+        const Vec2 offset(0.35f * f, 0.12f * f);
+        frames[f].ego_pose += offset;
+        for (auto& detection : frames[f].radar) detection.position += offset;
+    }
+    return frames;
+}
+
+// SceneConfig의 그리드와 파티클 수에 맞춘 DOGM 파라미터 (나머지는 기본값)
+inline DOGM::Params sceneParams(const SceneConfig& config) {
+    DOGM::Params params;
+    params.resolution = config.resolution;
+    params.size = config.grid_cells_per_side * config.resolution;
+    params.particle_count = config.particle_count;
+    params.new_born_particle_count = std::max(1, config.particle_count / 10);
+    params.grid_layout = config.layout;
+    return params;
+}
+
+// 두 실행의 결과가 같은지 비교하기 위한 셀 질량과 파티클 상태의 합
+inline double gridChecksum(const DOGM& grid) {
+    double sum = 0.0;
+    for (const GridCell& cell : grid.getGridCells()) sum += cell.occ_mass + 0.5 * cell.free_mass;
+    const ParticlesSoA& particles = grid.getParticles();
+    for (size_t i = 0; i < particles.size(); ++i) sum += 1e-3 * (particles.x[i] + particles.vy[i]);
+    return sum;
+}
+
+// DOGM::updateGrid와 같은 순서로 커널을 한 번 실행하여 각 커널의 실제적인 입력을 만든다.
+inline void buildScene(KernelScene& scene, const SceneConfig& config) {
+    scene.config = config;
+    scene.params = sceneParams(config);
+    scene.grid_size = static_cast<int>(scene.params.size / scene.params.resolution);
+    scene.window = GridWindow(scene.grid_size, scene.params.resolution, config.layout);
+    scene.cell_count = scene.window.storageSize();
+
+    const DOGM::Params& params = scene.params;
+    scene.frame = makeSyntheticFrame(config, params.size, 1);
+
+    scene.meas_cells.resize(scene.cell_count);
+    scene.grid_cells.resize(scene.cell_count);
+    scene.grid_moments.resize(scene.cell_count);
+    scene.weight_array.resize(params.particle_count);
+    scene.born_masses_array.resize(scene.cell_count);
+    scene.birth_weight_array.resize(params.new_born_particle_count);
+    scene.particles.resize(params.particle_count);
+    scene.particles_next.resize(params.particle_count);
+    scene.birth_particles.resize(params.new_born_particle_count);
+
+    kernel::initGridCells(scene.grid_cells, scene.meas_cells);
+    scene.workspace.radar.configure(params.radar_splat_radius, params.radar_splat_sigma);
+    scene.rng.setFrame(0);
+    kernel::initParticles(scene.particles, scene.rng, params.init_max_velocity, scene.window);
+    scene.rng.setFrame(1);
+
+    kernel::fuseAndCreateMeasurementGrid(scene.meas_cells, SensorFrameView(scene.frame), scene.window,
+                                         scene.frame.ego_pose, scene.frame.ego_yaw, scene.workspace.rays,
+                                         scene.workspace.radar, scene.measured_cells);
+
+    scene.before_predict = scene.particles;
+    kernel::predict(scene.particles, scene.rng, params, scene.window, scene.dt);
+
+    scene.unsorted = scene.particles;
+    kernel::particleToGrid(scene.particles, scene.particles_next, scene.grid_cells, scene.weight_array,
+                           scene.workspace.cell_histogram, scene.particle_cells);
+    std::swap(scene.particles, scene.particles_next);
+    scene.active_cells.assignUnion(scene.measured_cells, scene.particle_cells);
+
+    scene.cells_before_occupancy = scene.grid_cells;
+    kernel::updateOccupancy(scene.grid_cells, scene.weight_array, scene.meas_cells, scene.born_masses_array,
+                            params, scene.dt);
+
+    scene.weights_before_persistent = scene.weight_array;
+    kernel::updatePersistent(scene.particles, scene.meas_cells, scene.grid_cells, scene.weight_array);
+
+    kernel::initNewParticles(scene.birth_particles, scene.meas_cells, scene.born_masses_array, scene.rng, params,
+                             scene.window, scene.workspace.birth);
+    scene.birth_weight_array.assign(scene.birth_particles.weight.begin(), scene.birth_particles.weight.end());
+    scene.scan_input = scene.weight_array;
+    scene.scan_input.insert(scene.scan_input.end(), scene.birth_weight_array.begin(), scene.birth_weight_array.end());
+    scene.scan_output.resize(scene.scan_input.size());
+    scene.params.resampling_method = ResamplingMethod::Multinomial;
+
+    kernel::computeStatisticalMoments(scene.particles, scene.grid_cells, scene.grid_moments, scene.weight_array);
+
+    scene.dogm.reset(new DOGM(params));
+    scene.dogm->updateGrid(scene.frame, scene.dt);
+
+    DOGM::Params dense_params = params;
+    dense_params.sparse_cells = false;
+    scene.dogm_dense.reset(new DOGM(dense_params));
+    scene.dogm_dense->updateGrid(scene.frame, scene.dt);
+}
+
+} // namespace bench
+} // namespace dogm
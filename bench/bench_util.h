@@ -0,0 +1,113 @@
+#pragma once
+
+// dogm_bench용 최소 벤치마크 하니스 (Google Benchmark 스타일 출력, 외부 의존성 없음)
+
+#include <omp.h>
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace dogm {
+namespace bench {
+
+template<typename Scene>
+struct BenchCase {
+    std::string name;
+    std::string unit;                          // 처리 단위: "particle", "cell", "beam", ...
+    std::function<size_t(const Scene&)> items; // 반복당 처리 단위 수
+    std::function<void(Scene&)> setup;         // 측정 제외 (입력 복원 등)
+    std::function<void(Scene&)> run;           // 측정 대상
+};
+
+struct BenchResult {
+    std::string name;
+    std::string unit;
+    int threads = 1;
+    int iterations = 0;
+    double median_ms = 0.0;
+    double min_ms = 0.0;
+    double ns_per_item = 0.0;
+};
+
+// min_time_ms 이상, 최소 min_iterations회 반복하고 중앙값을 사용한다.
+template<typename Scene>
+BenchResult runCase(const BenchCase<Scene>& bench_case, Scene& scene, int threads,
+                    double min_time_ms = 200.0, int min_iterations = 5) {
+    omp_set_num_threads(threads);
+
+    std::vector<double> samples;
+    double total_ms = 0.0;
+    // warm-up
+    if (bench_case.setup) bench_case.setup(scene);
+    bench_case.run(scene);
+
+    while (total_ms < min_time_ms || static_cast<int>(samples.size()) < min_iterations) {
+        if (bench_case.setup) bench_case.setup(scene);
+        auto start = std::chrono::high_resolution_clock::now();
+        bench_case.run(scene);
+        auto end = std::chrono::high_resolution_clock::now();
+        double ms = std::chrono::duration<double, std::milli>(end - start).count();
+        samples.push_back(ms);
+        total_ms += ms;
+        if (samples.size() >= 10000) break;
+    }
+
+    std::sort(samples.begin(), samples.end());
+    BenchResult result;
+    result.name = bench_case.name;
+    result.unit = bench_case.unit;
+    result.threads = threads;
+    result.iterations = static_cast<int>(samples.size());
+    result.median_ms = samples[samples.size() / 2];
+    result.min_ms = samples.front();
+    size_t items = bench_case.items(scene);
+    result.ns_per_item = items > 0 ? result.median_ms * 1e6 / items : 0.0;
+    return result;
+}
+
+inline void printHeader(std::ostream& out) {
+    out << std::left << std::setw(34) << "Benchmark" << std::right
+        << std::setw(8) << "Threads" << std::setw(8) << "Iters"
+        << std::setw(12) << "Median ms" << std::setw(12) << "Min ms"
+        << std::setw(14) << "ns/item" << "  " << std::left << std::setw(10) << "Unit"
+        << std::right << std::setw(10) << "Speedup" << std::endl;
+    out << std::string(110, '-') << std::endl;
+}
+
+inline void printResult(std::ostream& out, const BenchResult& result, double single_thread_ms) {
+    out << std::left << std::setw(34) << result.name << std::right << std::fixed
+        << std::setw(8) << result.threads << std::setw(8) << result.iterations
+        << std::setw(12) << std::setprecision(3) << result.median_ms
+        << std::setw(12) << std::setprecision(3) << result.min_ms
+        << std::setw(14) << std::setprecision(2) << result.ns_per_item << "  "
+        << std::left << std::setw(10) << result.unit << std::right
+        << std::setw(9) << std::setprecision(2) << (single_thread_ms > 0 ? single_thread_ms / result.median_ms : 1.0)
+        << "x" << std::endl;
+}
+
+inline void printCsvHeader(std::ostream& out) {
+    out << "benchmark,threads,iterations,median_ms,min_ms,ns_per_item,unit\n";
+}
+
+inline void printCsv(std::ostream& out, const BenchResult& result) {
+    out << result.name << "," << result.threads << "," << result.iterations << ","
+        << result.median_ms << "," << result.min_ms << "," << result.ns_per_item << "," << result.unit << "\n";
+}
+
+inline std::vector<int> parseIntList(const std::string& text) {
+    std::vector<int> values;
+    std::stringstream ss(text);
+    std::string token;
+    while (std::getline(ss, token, ',')) {
+        if (!token.empty()) values.push_back(std::stoi(token));
+    }
+    return values;
+}
+
+} // namespace bench
+} // namespace dogm
@@ -0,0 +1,168 @@
+// Compact 파티클 상태(compact_particle_state)와 float 상태의 비교.
+// (1) 부호화 왕복 오차 (2) 스테이지별 시간과 프레임 사이 상태 크기 (3) 같은 입력에서의 그리드 차이.
+// 그리드 차이는 seed만 다른 float 실행끼리의 차이(몬테카를로 잡음)와 함께 출력해 비교 기준으로 삼는다.
+//
+// 사용법: dogm_compact_bench [grid_cells_per_side=400] [particles=1000000] [frames=20]
+#include "bench_scene.h"
+#include "bench_util.h"
+#include "dogm/kernel/compact.h"
+#include "dogm/particle_codec.h"
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+using namespace dogm;
+using namespace dogm::bench;
+
+namespace {
+
+DOGM::Params benchParams(const SceneConfig& config, bool compact, unsigned int seed) {
+    DOGM::Params params = sceneParams(config);
+    params.compact_particle_state = compact;
+    params.random_seed = seed;
+    return params;
+}
+
+void printCodecErrors(const SceneConfig& config) {
+    const int grid_size = config.grid_cells_per_side;
+    GridWindow window(grid_size, config.resolution, GridLayout::RowMajor);
+    RandomGenerator rng(42);
+    ParticlesSoA particles, decoded;
+    CompactParticlesSoA compact;
+    particles.resize(config.particle_count);
+    kernel::initParticles(particles, rng, 30.0f, window);
+    // 가중치는 [2^-40, 1] 범위의 log-uniform
+    for (size_t i = 0; i < particles.size(); ++i) {
+        particles.weight[i] = std::exp2(-40.0f * rng.uniform(RandomStream::Resample, static_cast<uint32_t>(i)));
+    }
+
+    kernel::encodeParticles(particles, compact);
+    kernel::decodeParticles(compact, decoded, window);
+
+    double max_position = 0.0, max_velocity = 0.0, max_velocity_rel = 0.0, max_weight_rel = 0.0;
+    for (size_t i = 0; i < particles.size(); ++i) {
+        max_position = std::max({max_position, std::abs(static_cast<double>(decoded.x[i]) - particles.x[i]),
+                                 std::abs(static_cast<double>(decoded.y[i]) - particles.y[i])});
+        for (float v : {particles.vx[i], particles.vy[i]}) {
+            const double d = std::abs(static_cast<double>(halfToFloat(floatToHalf(v))) - v);
+            max_velocity = std::max(max_velocity, d);
+            if (std::abs(v) > 1e-3f) max_velocity_rel = std::max(max_velocity_rel, d / std::abs(v));
+        }
+        max_weight_rel = std::max(max_weight_rel,
+                                  std::abs(static_cast<double>(decoded.weight[i]) - particles.weight[i]) /
+                                      particles.weight[i]);
+    }
+    std::cout << "codec round trip (" << particles.size() << " particles, |v| <= 30 m/s):" << std::endl
+              << std::scientific << std::setprecision(2)
+              << "  position  max " << max_position << " cells (" << max_position * config.resolution << " m)"
+              << std::endl
+              << "  velocity  max " << max_velocity << " m/s, relative " << max_velocity_rel << std::endl
+              << "  weight    max relative " << max_weight_rel << std::endl
+              << std::fixed << std::endl;
+}
+
+struct GridDiff {
+    double max_occupancy = 0.0;
+    double mean_occupancy = 0.0;
+    double mean_velocity = 0.0;   // 점유 셀(pignistic > 0.6)의 평균 속도 차이 [m/s]
+};
+
+float pignisticOf(const GridCell& cell) {
+    return cell.occ_mass + 0.5f * (1.0f - cell.occ_mass - cell.free_mass);
+}
+
+GridDiff compareGrids(const DOGM& a, const DOGM& b) {
+    const auto& cells_a = a.getGridCells();
+    const auto& cells_b = b.getGridCells();
+    const auto& moments_a = a.getGridMoments();
+    const auto& moments_b = b.getGridMoments();
+    GridDiff diff;
+    double velocity_sum = 0.0;
+    int occupied = 0;
+    for (size_t i = 0; i < cells_a.size(); ++i) {
+        const double pa = pignisticOf(cells_a[i]);
+        const double pb = pignisticOf(cells_b[i]);
+        diff.max_occupancy = std::max(diff.max_occupancy, std::abs(pa - pb));
+        diff.mean_occupancy += std::abs(pa - pb);
+        if (pa > 0.6 && pb > 0.6) {
+            velocity_sum += std::hypot(moments_a[i].mean_x_vel - moments_b[i].mean_x_vel,
+                                       moments_a[i].mean_y_vel - moments_b[i].mean_y_vel);
+            ++occupied;
+        }
+    }
+    diff.mean_occupancy /= std::max<size_t>(cells_a.size(), 1);
+    diff.mean_velocity = occupied > 0 ? velocity_sum / occupied : 0.0;
+    return diff;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    SceneConfig config;
+    config.grid_cells_per_side = (argc > 1) ? std::atoi(argv[1]) : 400;
+    config.particle_count = (argc > 2) ? std::atoi(argv[2]) : 1000000;
+    const int frames = (argc > 3) ? std::atoi(argv[3]) : 20;
+    const float dt = 0.1f;
+
+    std::cout << "grid " << config.grid_cells_per_side << "x" << config.grid_cells_per_side << ", particles "
+              << config.particle_count << ", frames " << frames << ", threads " << omp_get_max_threads()
+              << std::endl << std::endl;
+
+    printCodecErrors(config);
+
+    DOGM float_grid(benchParams(config, false, 123456));
+    DOGM compact_grid(benchParams(config, true, 123456));
+    DOGM reseeded_grid(benchParams(config, false, 654321));
+
+    const Stage stages[] = {Stage::Prediction, Stage::Assignment, Stage::Resampling};
+    double float_ms[3] = {}, compact_ms[3] = {}, float_total = 0.0, compact_total = 0.0;
+    GridDiff compact_diff, seed_diff;
+
+    for (int f = 0; f < frames; ++f) {
+        const SensorFrame frame = makeSyntheticFrame(config, config.grid_cells_per_side * config.resolution, f + 1);
+        float_grid.updateGrid(frame, dt);
+        compact_grid.updateGrid(frame, dt);
+        reseeded_grid.updateGrid(frame, dt);
+
+        // 첫 프레임은 warm-up
+        if (f > 0) {
+            for (int s = 0; s < 3; ++s) {
+                float_ms[s] += float_grid.getStats().stage_ms[static_cast<int>(stages[s])];
+                compact_ms[s] += compact_grid.getStats().stage_ms[static_cast<int>(stages[s])];
+            }
+            float_total += float_grid.getStats().total_ms;
+            compact_total += compact_grid.getStats().total_ms;
+        }
+        if (f == frames - 1) {
+            compact_diff = compareGrids(float_grid, compact_grid);
+            seed_diff = compareGrids(float_grid, reseeded_grid);
+        }
+    }
+
+    const int timed = std::max(frames - 1, 1);
+    std::cout << "mean ms per frame" << std::endl
+              << std::setw(22) << "stage" << std::setw(12) << "float" << std::setw(12) << "compact"
+              << std::setw(10) << "speedup" << std::endl;
+    auto print_row = [&](const char* name, double a, double b) {
+        std::cout << std::setw(22) << name << std::setprecision(3) << std::setw(12) << a / timed
+                  << std::setw(12) << b / timed << std::setw(9) << std::setprecision(2) << (b > 0 ? a / b : 0.0)
+                  << "x" << std::endl;
+    };
+    for (int s = 0; s < 3; ++s) print_row(stageName(stages[s]), float_ms[s], compact_ms[s]);
+    print_row("total", float_total, compact_total);
+
+    // 프레임 사이에 유지되는 파티클 상태 (float은 particles + particles_next, weight_array는 양쪽 공통)
+    const size_t float_state = 5 * sizeof(float) + sizeof(int) + sizeof(char);  // x, y, vx, vy, weight, idx, associated
+    const size_t compact_state = 7 * sizeof(int16_t);
+    std::cout << std::endl << "particle buffers: float " << 2 * float_state << " B/particle, compact "
+              << compact_state + float_state << " B/particle (state " << float_state << " B -> " << compact_state
+              << " B, plus one float working set)" << std::endl << std::endl;
+
+    std::cout << "grid difference after " << frames << " frames" << std::setprecision(4) << std::endl
+              << "  float vs compact:         occupancy max " << compact_diff.max_occupancy << ", mean "
+              << compact_diff.mean_occupancy << ", velocity mean " << compact_diff.mean_velocity << " m/s" << std::endl
+              << "  float vs float (seed):    occupancy max " << seed_diff.max_occupancy << ", mean "
+              << seed_diff.mean_occupancy << ", velocity mean " << seed_diff.mean_velocity << " m/s" << std::endl;
+    return 0;
+}
@@ -0,0 +1,430 @@
+// DOGM 커널별 micro-benchmark.
+//
+// 사용법: dogm_bench [--grid 400[,800]] [--particles 200000[,...]] [--beams 1080] [--radar 500]
+//                    [--threads 1,2,4,8] [--layout rowmajor,tiled,morton] [--filter predict]
+//                    [--min-time-ms 200] [--csv results.csv]
+//
+// 각 커널은 합성 장면(bench_scene.h)의 입력 스냅샷으로 개별 실행되며, 결과는 처리 단위당
+// ns(ns/particle, ns/cell, ns/beam)와 1스레드 대비 speedup으로 보고된다.
+
+#include "bench_scene.h"
+#include "bench_util.h"
+#include "dogm/fast_math.h"
+#include <cstdlib>
+#include <fstream>
+#include <map>
+#include <numeric>
+
+using namespace dogm;
+using namespace dogm::bench;
+
+namespace {
+
+using Case = BenchCase<KernelScene>;
+
+const ResamplingMethod kResamplingMethods[] = {
+    ResamplingMethod::Multinomial, ResamplingMethod::Systematic, ResamplingMethod::Stratified,
+    ResamplingMethod::Residual, ResamplingMethod::ParallelSystematic
+};
+
+const char* resamplingMethodName(ResamplingMethod method) {
+    switch (method) {
+    case ResamplingMethod::Multinomial: return "multinomial";
+    case ResamplingMethod::Systematic: return "systematic";
+    case ResamplingMethod::Stratified: return "stratified";
+    case ResamplingMethod::Residual: return "residual";
+    case ResamplingMethod::ParallelSystematic: return "parallel_systematic";
+    }
+    return "unknown";
+}
+
+// Resampling 품질: 입력 ESS, 살아남은 조상 수, 기대 복제 수 N * w_j 대비 복제 수의 평균 제곱 오차.
+// 오차가 작을수록 resampling이 더하는 분산이 작다.
+void printResamplingQuality(KernelScene& scene) {
+    kernel::ResamplingWorkspace& ws = scene.workspace.resampling;
+    ws.joint_weights = scene.weight_array;
+    ws.joint_weights.insert(ws.joint_weights.end(), scene.birth_weight_array.begin(), scene.birth_weight_array.end());
+    accumulate(ws.joint_weights, ws.accum_weights);
+
+    const double total = ws.accum_weights.back();
+    const int sample_count = static_cast<int>(scene.particles.size());
+    double sum_sq = 0.0;
+    for (float w : ws.joint_weights) sum_sq += static_cast<double>(w) * w;
+
+    std::cout << "\nResampling quality (input ESS " << std::fixed << std::setprecision(1)
+              << total * total / sum_sq << " of " << ws.joint_weights.size() << ")" << std::endl;
+    std::cout << std::left << std::setw(24) << "Method" << std::right << std::setw(14) << "Ancestors"
+              << std::setw(16) << "Offspring MSE" << std::endl;
+
+    for (ResamplingMethod method : kResamplingMethods) {
+        kernel::selectAncestors(method, ws.joint_weights, sample_count, scene.rng, ws);
+        std::vector<int> offspring(ws.joint_weights.size(), 0);
+        for (int a : ws.ancestors) ++offspring[a];
+
+        int unique = 0;
+        double mse = 0.0;
+        for (size_t j = 0; j < offspring.size(); ++j) {
+            unique += offspring[j] > 0;
+            double expected = sample_count * ws.joint_weights[j] / total;
+            mse += (offspring[j] - expected) * (offspring[j] - expected);
+        }
+        std::cout << std::left << std::setw(24) << resamplingMethodName(method) << std::right
+                  << std::setw(14) << unique << std::setw(16) << std::setprecision(4)
+                  << mse / offspring.size() << std::endl;
+    }
+}
+
+// 10^6개 가중치의 누적합을 long double 기준값과 비교한 최대 상대 오차 (float 직렬 partial_sum vs inclusiveScan)
+void printScanDrift() {
+    const size_t n = 1000000;
+    std::vector<float> weights(n);
+    RandomGenerator rng(3);
+    for (size_t i = 0; i < n; ++i) weights[i] = rng.uniform(RandomStream::Resample, static_cast<uint32_t>(i)) / n;
+
+    std::vector<float> serial(n), scanned(n);
+    std::partial_sum(weights.begin(), weights.end(), serial.begin());
+    accumulate(weights, scanned);
+
+    long double reference = 0.0L;
+    double serial_error = 0.0, scan_error = 0.0;
+    for (size_t i = 0; i < n; ++i) {
+        reference += weights[i];
+        serial_error = std::max(serial_error, static_cast<double>(std::abs((serial[i] - reference) / reference)));
+        scan_error = std::max(scan_error, static_cast<double>(std::abs((scanned[i] - reference) / reference)));
+    }
+    std::cout << "Prefix sum drift over " << n << " floats: max rel error partial_sum " << std::scientific
+              << std::setprecision(2) << serial_error << ", inclusiveScan " << scan_error << std::fixed
+              << std::endl;
+}
+
+void restoreCellUpdateInputs(KernelScene& s) {
+    s.grid_cells = s.cells_before_occupancy;
+    s.weight_array = s.weights_before_persistent;
+    std::fill(s.grid_moments.begin(), s.grid_moments.end(), GridCellMoments());
+}
+
+void runStagedCellUpdate(KernelScene& s) {
+    kernel::updateOccupancy(s.grid_cells, s.weight_array, s.meas_cells, s.born_masses_array, s.params, s.dt);
+    kernel::updatePersistent(s.particles, s.meas_cells, s.grid_cells, s.weight_array);
+    kernel::computeStatisticalMoments(s.particles, s.grid_cells, s.grid_moments, s.weight_array);
+}
+
+void runFusedCellUpdate(KernelScene& s) {
+    kernel::updateCellsFused(s.grid_cells, s.grid_moments, s.particles, s.weight_array, s.meas_cells,
+                             s.born_masses_array, s.params, s.dt);
+}
+
+// 활성 셀(파티클 또는 측정이 있는 셀)만 갱신. 입력 셀은 모두 시각 0이므로 밀린 decay는 없다.
+void runSparseCellUpdate(KernelScene& s) {
+    kernel::CellClock clock;
+    clock.current = s.dt;
+    kernel::updateCellsFusedSparse(s.grid_cells, s.grid_moments, s.active_cells, s.particles, s.weight_array,
+                                   s.meas_cells, s.sparse_born_masses, s.params, s.dt, clock);
+}
+
+void printCellDifference(const char* label, const std::vector<GridCell>& expected_cells,
+                         const std::vector<GridCellMoments>& expected_moments,
+                         const std::vector<float>& expected_weights, const KernelScene& scene) {
+    float max_mass = 0.0f, max_velocity = 0.0f, max_weight = 0.0f;
+    for (size_t i = 0; i < expected_cells.size(); ++i) {
+        const GridCell& a = expected_cells[i];
+        const GridCell& b = scene.grid_cells[i];
+        max_mass = std::max({max_mass, std::abs(a.occ_mass - b.occ_mass), std::abs(a.free_mass - b.free_mass),
+                             std::abs(a.pers_occ_mass - b.pers_occ_mass)});
+        const GridCellMoments& ma = expected_moments[i];
+        const GridCellMoments& mb = scene.grid_moments[i];
+        max_velocity = std::max({max_velocity, std::abs(ma.mean_x_vel - mb.mean_x_vel),
+                                 std::abs(ma.mean_y_vel - mb.mean_y_vel)});
+    }
+    for (size_t i = 0; i < expected_weights.size(); ++i) {
+        max_weight = std::max(max_weight, std::abs(expected_weights[i] - scene.weight_array[i]));
+    }
+    std::cout << label << ": max |d mass| " << std::scientific << std::setprecision(2)
+              << max_mass << ", max |d mean vel| " << max_velocity << ", max |d weight| " << max_weight
+              << std::fixed << std::endl;
+}
+
+// fused/sparse 커널과 staged 경로의 최대 차이. 연산 순서가 같으므로 모두 0이어야 한다.
+void printCellUpdateAgreement(KernelScene& scene) {
+    restoreCellUpdateInputs(scene);
+    runStagedCellUpdate(scene);
+    const std::vector<GridCell> staged_cells = scene.grid_cells;
+    const std::vector<GridCellMoments> staged_moments = scene.grid_moments;
+    const std::vector<float> staged_weights = scene.weight_array;
+
+    std::cout << std::endl;
+    restoreCellUpdateInputs(scene);
+    runFusedCellUpdate(scene);
+    printCellDifference("Fused cell update vs staged", staged_cells, staged_moments, staged_weights, scene);
+
+    restoreCellUpdateInputs(scene);
+    runSparseCellUpdate(scene);
+    kernel::applyPendingDecay(scene.grid_cells, scene.grid_moments, scene.dt, scene.params.freespace_discount);
+    printCellDifference("Sparse cell update vs staged", staged_cells, staged_moments, staged_weights, scene);
+    std::cout << "Active cells: " << scene.active_cells.list.size() << " / " << scene.cell_count << std::endl;
+
+    // 이후 케이스는 staged 결과를 입력으로 사용
+    scene.grid_cells = staged_cells;
+    scene.grid_moments = staged_moments;
+    scene.weight_array = staged_weights;
+}
+
+// Doppler likelihood 평가만 떼어 낸 비교. 게이트 없이 모든 파티클에 대해 자기 셀의 radar 값으로 계산한다.
+//  trig:    파티클마다 atan2/cos/sin + std::exp (셀에 시선 벡터를 캐시하기 전 방식)
+//  std_exp: 셀에 캐시된 시선 벡터와 내적 + std::exp
+//  fast:    내적 + fastExp (커널이 쓰는 방식)
+enum class DopplerEval { Trig, StdExp, Fast };
+
+template<DopplerEval Eval>
+void evaluateDoppler(KernelScene& s) {
+    const ParticlesSoA& particles = s.particles;
+    const Vec2 ego = (s.frame.ego_pose - s.window.originMeters()) / s.params.resolution;
+    float* out = s.scan_output.data();
+    const int count = static_cast<int>(particles.size());
+    #pragma omp parallel for
+    for (int i = 0; i < count; ++i) {
+        const MeasurementCell& meas_cell = s.meas_cells[particles.grid_cell_idx[i]];
+        const float var = std::max(meas_cell.radial_velocity_var, 0.01f);
+        if (Eval == DopplerEval::Trig) {
+            const float angle = std::atan2(particles.y[i] - ego.y(), particles.x[i] - ego.x());
+            const float diff = particles.vx[i] * std::cos(angle) + particles.vy[i] * std::sin(angle) -
+                               meas_cell.radial_velocity;
+            out[i] = std::exp(-0.5f * diff * diff / var);
+        } else if (Eval == DopplerEval::StdExp) {
+            const float diff = particles.vx[i] * meas_cell.los_x + particles.vy[i] * meas_cell.los_y -
+                               meas_cell.radial_velocity;
+            out[i] = std::exp(diff * diff * (-0.5f / var));
+        } else {
+            out[i] = dopplerLikelihood(particles.vx[i], particles.vy[i], meas_cell.los_x, meas_cell.los_y,
+                                       meas_cell.radial_velocity, -0.5f / var);
+        }
+    }
+}
+
+size_t particleItems(const KernelScene& scene) { return scene.particles.size(); }
+size_t cellItems(const KernelScene& scene) { return scene.cell_count; }
+
+std::vector<Case> makeKernelCases() {
+    std::vector<Case> cases;
+
+    cases.push_back({"predict", "particle", particleItems,
+        [](KernelScene& s) { s.work = s.before_predict; },
+        [](KernelScene& s) { kernel::predict(s.work, s.rng, s.params, s.window, s.dt); }});
+
+    // 커널 수준별 비교. 이 CPU/빌드에서 실행할 수 없는 수준은 건너뛴다.
+    for (SimdLevel level : {SimdLevel::Scalar, SimdLevel::AVX2, SimdLevel::AVX512}) {
+        if (!isSimdLevelSupported(level)) continue;
+        cases.push_back({std::string("predict/") + simdLevelName(level), "particle", particleItems,
+            [](KernelScene& s) { s.work = s.before_predict; },
+            [level](KernelScene& s) { kernel::predict(s.work, s.rng, s.params, s.window, s.dt, level); }});
+    }
+
+    cases.push_back({"particleToGrid", "particle", particleItems, nullptr,
+        [](KernelScene& s) {
+            kernel::particleToGrid(s.unsorted, s.work, s.grid_cells, s.weight_array, s.workspace.cell_histogram,
+                                   s.particle_cells);
+        }});
+
+    cases.push_back({"updateOccupancy", "cell", cellItems,
+        [](KernelScene& s) { s.grid_cells = s.cells_before_occupancy; },
+        [](KernelScene& s) {
+            kernel::updateOccupancy(s.grid_cells, s.weight_array, s.meas_cells, s.born_masses_array, s.params, s.dt);
+        }});
+
+    cases.push_back({"updatePersistent", "particle", particleItems,
+        [](KernelScene& s) { s.weight_array = s.weights_before_persistent; },
+        [](KernelScene& s) {
+            kernel::updatePersistent(s.particles, s.meas_cells, s.grid_cells, s.weight_array);
+        }});
+
+    cases.push_back({"doppler/trig", "particle", particleItems, nullptr, evaluateDoppler<DopplerEval::Trig>});
+    cases.push_back({"doppler/std_exp", "particle", particleItems, nullptr, evaluateDoppler<DopplerEval::StdExp>});
+    cases.push_back({"doppler/fastExp", "particle", particleItems, nullptr, evaluateDoppler<DopplerEval::Fast>});
+
+    cases.push_back({"initNewParticles", "particle",
+        [](const KernelScene& s) { return s.birth_particles.size(); }, nullptr,
+        [](KernelScene& s) {
+            kernel::initNewParticles(s.birth_particles, s.meas_cells, s.born_masses_array, s.rng, s.params,
+                                     s.window, s.workspace.birth);
+        }});
+
+    cases.push_back({"computeStatisticalMoments", "cell", cellItems, nullptr,
+        [](KernelScene& s) {
+            kernel::computeStatisticalMoments(s.particles, s.grid_cells, s.grid_moments, s.weight_array);
+        }});
+
+    // occupancy + persistent + moments: 스테이지별 커널 vs 셀 단위 fused 커널
+    cases.push_back({"cellUpdate/staged", "cell", cellItems, restoreCellUpdateInputs, runStagedCellUpdate});
+    cases.push_back({"cellUpdate/fused", "cell", cellItems, restoreCellUpdateInputs, runFusedCellUpdate});
+    cases.push_back({"cellUpdate/sparse", "cell", cellItems, restoreCellUpdateInputs, runSparseCellUpdate});
+
+    // resampling 가중치 누적합: 직렬 float partial_sum vs blocked 병렬 scan (double 누적)
+    auto scanItems = [](const KernelScene& s) { return s.scan_input.size(); };
+    cases.push_back({"scan/partial_sum", "particle", scanItems, nullptr,
+        [](KernelScene& s) { std::partial_sum(s.scan_input.begin(), s.scan_input.end(), s.scan_output.begin()); }});
+    cases.push_back({"scan/inclusiveScan", "particle", scanItems, nullptr,
+        [](KernelScene& s) { accumulate(s.scan_input, s.scan_output); }});
+
+    for (ResamplingMethod method : kResamplingMethods) {
+        cases.push_back({std::string("resample/") + resamplingMethodName(method), "particle", particleItems,
+            [method](KernelScene& s) { s.params.resampling_method = method; },
+            [](KernelScene& s) {
+                kernel::resample(s.particles, s.particles_next, s.birth_particles, s.weight_array,
+                                 s.birth_weight_array, s.rng, s.params, s.window, s.workspace.resampling);
+            }});
+    }
+
+    cases.push_back({"fuseAndCreateMeasurementGrid", "cell", cellItems, nullptr,
+        [](KernelScene& s) {
+            kernel::fuseAndCreateMeasurementGrid(s.meas_cells, SensorFrameView(s.frame), s.window,
+                                                 s.frame.ego_pose, s.frame.ego_yaw, s.workspace.rays,
+                                                 s.workspace.radar, s.measured_cells);
+        }});
+
+    cases.push_back({"fuseAndCreateMeasurementGrid/beam", "beam",
+        [](const KernelScene& s) { return s.frame.lidar.ranges.size(); }, nullptr,
+        [](KernelScene& s) {
+            kernel::fuseAndCreateMeasurementGrid(s.meas_cells, SensorFrameView(s.frame), s.window,
+                                                 s.frame.ego_pose, s.frame.ego_yaw, s.workspace.rays,
+                                                 s.workspace.radar, s.measured_cells);
+        }});
+
+    cases.push_back({"DOGM::updateGrid", "particle", particleItems, nullptr,
+        [](KernelScene& s) { s.dogm->updateGrid(s.frame, s.dt); }});
+    cases.push_back({"DOGM::updateGrid/dense", "particle", particleItems, nullptr,
+        [](KernelScene& s) { s.dogm_dense->updateGrid(s.frame, s.dt); }});
+
+    return cases;
+}
+
+struct Options {
+    std::vector<int> grids = {400};
+    std::vector<int> particles = {200000};
+    std::vector<int> beams = {1080};
+    std::vector<int> radar = {500};
+    std::vector<int> threads;
+    std::vector<GridLayout> layouts = {GridLayout::RowMajor};
+    std::string filter;
+    std::string csv_path;
+    double min_time_ms = 200.0;
+};
+
+// 품질 리포트는 case 필터와 같은 방향으로 고른다: --filter가 리포트의 case 묶음 이름을 포함할 때
+// (예: --filter resample/systematic은 "resample" 리포트를 출력한다)
+bool reportSelected(const Options& options, const char* group) {
+    return options.filter.empty() || options.filter.find(group) != std::string::npos;
+}
+
+Options parseOptions(int argc, char** argv) {
+    Options options;
+    options.threads = {1};
+    if (omp_get_max_threads() > 1) options.threads.push_back(omp_get_max_threads());
+
+    for (int i = 1; i + 1 < argc; i += 2) {
+        std::string key = argv[i];
+        std::string value = argv[i + 1];
+        if (key == "--grid") options.grids = parseIntList(value);
+        else if (key == "--particles") options.particles = parseIntList(value);
+        else if (key == "--beams") options.beams = parseIntList(value);
+        else if (key == "--radar") options.radar = parseIntList(value);
+        else if (key == "--threads") options.threads = parseIntList(value);
+        else if (key == "--layout") {
+            options.layouts.clear();
+            std::stringstream ss(value);
+            std::string name;
+            while (std::getline(ss, name, ',')) {
+                GridLayout layout;
+                if (!parseGridLayout(name, layout)) {
+                    std::cerr << "Unknown grid layout " << name << std::endl;
+                    std::exit(1);
+                }
+                options.layouts.push_back(layout);
+            }
+        }
+        else if (key == "--filter") options.filter = value;
+        else if (key == "--csv") options.csv_path = value;
+        else if (key == "--min-time-ms") options.min_time_ms = std::atof(value.c_str());
+        else {
+            std::cerr << "Unknown option " << key << std::endl;
+            std::exit(1);
+        }
+    }
+    return options;
+}
+
+void runScene(const Options& options, const SceneConfig& config, const std::vector<Case>& cases,
+              std::ofstream& csv) {
+    KernelScene scene;
+    buildScene(scene, config);
+
+    const int grid = config.grid_cells_per_side;
+    std::cout << "\nScene: grid " << grid << "x" << grid << " (" << scene.cell_count << " cells)"
+              << ", particles " << config.particle_count << ", beams " << config.beam_count
+              << ", radar " << config.radar_count << ", layout " << gridLayoutName(config.layout)
+              << ", simd " << simdLevelName(detectSimdLevel()) << std::endl;
+    if (reportSelected(options, "resample")) {
+        printResamplingQuality(scene);
+        std::cout << std::endl;
+    }
+    if (reportSelected(options, "scan")) {
+        printScanDrift();
+        std::cout << std::endl;
+    }
+    if (reportSelected(options, "cellUpdate")) {
+        printCellUpdateAgreement(scene);
+        std::cout << std::endl;
+    }
+    printHeader(std::cout);
+
+    const std::string suffix = "/g" + std::to_string(grid) + "/p" + std::to_string(config.particle_count) +
+                               "/b" + std::to_string(config.beam_count) + "/r" + std::to_string(config.radar_count) +
+                               "/" + gridLayoutName(config.layout);
+
+    for (const auto& bench_case : cases) {
+        if (!options.filter.empty() && bench_case.name.find(options.filter) == std::string::npos) {
+            continue;
+        }
+        double single_thread_ms = 0.0;
+        for (int threads : options.threads) {
+            BenchResult result = runCase(bench_case, scene, threads, options.min_time_ms);
+            if (threads == options.threads.front()) single_thread_ms = result.median_ms;
+            printResult(std::cout, result, single_thread_ms);
+            if (csv.is_open()) {
+                result.name += suffix;
+                printCsv(csv, result);
+            }
+        }
+    }
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Options options = parseOptions(argc, argv);
+    std::vector<Case> cases = makeKernelCases();
+
+    std::ofstream csv;
+    if (!options.csv_path.empty()) {
+        csv.open(options.csv_path);
+        printCsvHeader(csv);
+    }
+
+    for (int grid : options.grids) {
+        for (int particle_count : options.particles) {
+            for (int beam_count : options.beams) {
+                for (int radar_count : options.radar) {
+                    for (GridLayout layout : options.layouts) {
+                        SceneConfig config;
+                        config.grid_cells_per_side = grid;
+                        config.particle_count = particle_count;
+                        config.beam_count = beam_count;
+                        config.radar_count = radar_count;
+                        config.layout = layout;
+                        runScene(options, config, cases, csv);
+                    }
+                }
+            }
+        }
+    }
+    return 0;
+}
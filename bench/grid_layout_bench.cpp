@@ -0,0 +1,284 @@
+// grid_cells 저장 순서(GridLayout)별 벤치마크: updateGrid 시간, 스테이지 시간, 캐시 미스.
+//
+// 사용법: dogm_grid_layout_bench [grid_cells_per_side=400] [particles=200000] [frames=20]
+//
+// 캐시 미스는 두 가지로 보고한다.
+//  - hw: perf_event_open 하드웨어 카운터 (L1D read miss, LLC miss). PMU가 없거나 권한이 없으면 n/a.
+//  - model: 파티클 -> 셀 조회 순서(particleToGrid 입력)와 측정 셀 기록 순서를 LRU 캐시 모델
+//    (32 KiB 8-way L1, 1 MiB 16-way L2, 64 B line)에 통과시킨 미스 수. hot/cold 분리 전의
+//    셀 크기(GridCell + GridCellMoments)와 분리 후(GridCell)를 함께 보여준다.
+#include "bench_scene.h"
+#include <cstdint>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <list>
+#include <string>
+#include <vector>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+using namespace dogm;
+using namespace dogm::bench;
+
+namespace {
+
+// 하드웨어 캐시 미스 카운터 (현재 스레드와 이후 생성되는 스레드 포함)
+class CacheCounters {
+public:
+    CacheCounters() {
+#ifdef __linux__
+        fds[0] = open(PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                                              (PERF_COUNT_HW_CACHE_RESULT_MISS << 16));
+        fds[1] = open(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES);
+#endif
+    }
+    ~CacheCounters() {
+#ifdef __linux__
+        for (int fd : fds) if (fd >= 0) close(fd);
+#endif
+    }
+
+    bool available() const { return fds[0] >= 0 && fds[1] >= 0; }
+
+    void start() {
+#ifdef __linux__
+        for (int fd : fds) {
+            if (fd < 0) continue;
+            ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+            ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+        }
+#endif
+    }
+
+    // {L1D read miss, LLC miss}
+    void stop(uint64_t& l1d, uint64_t& llc) {
+        l1d = llc = 0;
+#ifdef __linux__
+        uint64_t values[2] = {0, 0};
+        for (int i = 0; i < 2; ++i) {
+            if (fds[i] < 0) continue;
+            ioctl(fds[i], PERF_EVENT_IOC_DISABLE, 0);
+            if (read(fds[i], &values[i], sizeof(uint64_t)) != sizeof(uint64_t)) values[i] = 0;
+        }
+        l1d = values[0];
+        llc = values[1];
+#endif
+    }
+
+private:
+    int fds[2] = {-1, -1};
+
+#ifdef __linux__
+    static int open(uint32_t type, uint64_t config) {
+        perf_event_attr attr;
+        std::memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = type;
+        attr.config = config;
+        attr.disabled = 1;
+        attr.inherit = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        return static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+    }
+#endif
+};
+
+// set-associative LRU 캐시 모델
+class CacheModel {
+public:
+    CacheModel(size_t size_bytes, int ways, int line_bytes = 64)
+        : ways(ways), line_shift(0), sets(size_bytes / line_bytes / ways) {
+        while ((1 << line_shift) < line_bytes) ++line_shift;
+        lines.resize(sets);
+    }
+
+    // 미스면 true
+    bool access(uint64_t address) {
+        const uint64_t line = address >> line_shift;
+        std::list<uint64_t>& set = lines[line % sets];
+        for (auto it = set.begin(); it != set.end(); ++it) {
+            if (*it == line) {
+                set.splice(set.begin(), set, it);
+                return false;
+            }
+        }
+        set.push_front(line);
+        if (static_cast<int>(set.size()) > ways) set.pop_back();
+        return true;
+    }
+
+private:
+    int ways;
+    int line_shift;
+    size_t sets;
+    std::vector<std::list<uint64_t>> lines;
+};
+
+struct ModelMisses {
+    uint64_t l1 = 0;
+    uint64_t l2 = 0;
+};
+
+// 셀 인덱스 순서대로 element_bytes 크기 원소를 읽을 때의 미스 수 (L2는 L1 미스만 본다)
+ModelMisses simulateCellStream(const std::vector<int>& cells, size_t element_bytes) {
+    CacheModel l1(32 * 1024, 8);
+    CacheModel l2(1024 * 1024, 16);
+    ModelMisses misses;
+    for (int cell : cells) {
+        const uint64_t address = static_cast<uint64_t>(cell) * element_bytes;
+        if (l1.access(address)) {
+            ++misses.l1;
+            misses.l2 += l2.access(address);
+        }
+    }
+    return misses;
+}
+
+// 분리 전 GridCell 크기: hot 필드 + 모멘트 (double 정렬)
+constexpr size_t kFatCellBytes = (sizeof(GridCell) + sizeof(GridCellMoments) + 7) / 8 * 8;
+
+struct LayoutResult {
+    double frame_ms = 0.0;
+    double assignment_ms = 0.0;
+    double cell_update_ms = 0.0;
+    double measurement_ms = 0.0;
+    bool hw = false;
+    double l1d_per_frame = 0.0;
+    double llc_per_frame = 0.0;
+    size_t lookups = 0;
+    ModelMisses lookup_hot, lookup_fat;
+    size_t meas_writes = 0;
+    ModelMisses meas;
+};
+
+LayoutResult runLayout(const SceneConfig& config, int frames) {
+    DOGM::Params params = sceneParams(config);
+    params.stats_histogram_window = frames;
+    DOGM dogm(params);
+
+    const float dt = 0.1f;
+    const int warmup = 5;
+    for (int f = 0; f < warmup; ++f) {
+        dogm.updateGrid(makeSyntheticFrame(config, params.size, f), dt);
+    }
+
+    std::vector<SensorFrame> inputs;
+    for (int f = 0; f < frames; ++f) inputs.push_back(makeSyntheticFrame(config, params.size, warmup + f));
+
+    LayoutResult result;
+    CacheCounters counters;
+    result.hw = counters.available();
+    std::vector<double> totals;
+    counters.start();
+    for (const SensorFrame& frame : inputs) {
+        auto start = std::chrono::steady_clock::now();
+        dogm.updateGrid(frame, dt);
+        totals.push_back(std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+    }
+    uint64_t l1d = 0, llc = 0;
+    counters.stop(l1d, llc);
+    result.l1d_per_frame = static_cast<double>(l1d) / frames;
+    result.llc_per_frame = static_cast<double>(llc) / frames;
+
+    std::sort(totals.begin(), totals.end());
+    result.frame_ms = totals[totals.size() / 2];
+    const LatencyHistogram& histogram = dogm.getLatencyHistogram();
+    result.assignment_ms = histogram.stages[static_cast<int>(Stage::Assignment)].percentile(50);
+    result.cell_update_ms = histogram.stages[static_cast<int>(Stage::OccupancyUpdate)].percentile(50);
+    result.measurement_ms = histogram.stages[static_cast<int>(Stage::MeasurementGrid)].percentile(50);
+
+    // 파티클 -> 셀 조회: resampling 직후 파티클 순서 그대로 (다음 particleToGrid의 입력 순서).
+    // grid_cell_idx는 predict에서 다시 계산되므로 위치로부터 구한다.
+    const ParticlesSoA& particles = dogm.getParticles();
+    const GridWindow& window = dogm.getGridWindow();
+    std::vector<int> lookups;
+    for (size_t i = 0; i < particles.size(); ++i) {
+        const int x = static_cast<int>(particles.x[i]);
+        const int y = static_cast<int>(particles.y[i]);
+        if (x < 0 || x >= window.grid_size || y < 0 || y >= window.grid_size) continue;
+        lookups.push_back(window.physicalIndex(x, y));
+    }
+    result.lookups = lookups.size();
+    result.lookup_hot = simulateCellStream(lookups, sizeof(GridCell));
+    result.lookup_fat = simulateCellStream(lookups, kFatCellBytes);
+
+    // 측정 셀 기록: Lidar 빔이 지나간 셀을 로컬 row-major 순서로 (fuseAndCreateMeasurementGrid)
+    const std::vector<MeasurementCell>& meas_cells = dogm.getMeasurementCells();
+    std::vector<int> meas_writes;
+    for (int y = 0; y < window.grid_size; ++y) {
+        for (int x = 0; x < window.grid_size; ++x) {
+            const int idx = window.physicalIndex(x, y);
+            if (meas_cells[idx].occ_mass > 0.0f || meas_cells[idx].free_mass > 0.0f) meas_writes.push_back(idx);
+        }
+    }
+    result.meas_writes = meas_writes.size();
+    result.meas = simulateCellStream(meas_writes, sizeof(MeasurementCell));
+    return result;
+}
+
+double perThousand(uint64_t misses, size_t accesses) {
+    return accesses > 0 ? 1000.0 * misses / accesses : 0.0;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    SceneConfig config;
+    config.grid_cells_per_side = (argc > 1) ? std::atoi(argv[1]) : 400;
+    config.particle_count = (argc > 2) ? std::atoi(argv[2]) : 200000;
+    const int frames = (argc > 3) ? std::atoi(argv[3]) : 20;
+
+    std::cout << "grid " << config.grid_cells_per_side << "x" << config.grid_cells_per_side
+              << ", particles " << config.particle_count << ", frames " << frames
+              << ", threads " << omp_get_max_threads() << std::endl;
+    std::cout << "GridCell " << sizeof(GridCell) << " B (hot), GridCellMoments " << sizeof(GridCellMoments)
+              << " B (cold), before split " << kFatCellBytes << " B" << std::endl << std::endl;
+
+    std::cout << std::left << std::setw(10) << "layout" << std::right << std::setw(9) << "cells"
+              << std::setw(10) << "frame ms" << std::setw(10) << "assign" << std::setw(10) << "cells ms"
+              << std::setw(10) << "meas ms" << std::setw(14) << "hw L1D/frame" << std::setw(14) << "hw LLC/frame"
+              << std::endl;
+
+    std::vector<LayoutResult> results;
+    const GridLayout layouts[] = {GridLayout::RowMajor, GridLayout::Tiled, GridLayout::Morton};
+    for (GridLayout layout : layouts) {
+        config.layout = layout;
+        LayoutResult r = runLayout(config, frames);
+        GridIndexer indexer(config.grid_cells_per_side, layout);
+        std::cout << std::left << std::setw(10) << gridLayoutName(layout) << std::right << std::fixed
+                  << std::setw(9) << indexer.storage_size << std::setprecision(3)
+                  << std::setw(10) << r.frame_ms << std::setw(10) << r.assignment_ms
+                  << std::setw(10) << r.cell_update_ms << std::setw(10) << r.measurement_ms;
+        if (r.hw) {
+            std::cout << std::setprecision(0) << std::setw(14) << r.l1d_per_frame << std::setw(14) << r.llc_per_frame;
+        } else {
+            std::cout << std::setw(14) << "n/a" << std::setw(14) << "n/a";
+        }
+        std::cout << std::endl;
+        results.push_back(r);
+    }
+
+    std::cout << std::endl << "Cache model misses per 1000 accesses (L1 / L2)" << std::endl;
+    std::cout << std::left << std::setw(10) << "layout" << std::right
+              << std::setw(22) << "lookup, hot cell" << std::setw(22) << "lookup, before split"
+              << std::setw(22) << "meas cell writes" << std::endl;
+    for (size_t i = 0; i < results.size(); ++i) {
+        const LayoutResult& r = results[i];
+        auto pair = [](const ModelMisses& m, size_t n) {
+            std::ostringstream out;
+            out << std::fixed << std::setprecision(1) << perThousand(m.l1, n) << " / " << perThousand(m.l2, n);
+            return out.str();
+        };
+        std::cout << std::left << std::setw(10) << gridLayoutName(layouts[i]) << std::right
+                  << std::setw(22) << pair(r.lookup_hot, r.lookups) << std::setw(22) << pair(r.lookup_fat, r.lookups)
+                  << std::setw(22) << pair(r.meas, r.meas_writes) << std::endl;
+    }
+    return 0;
+}
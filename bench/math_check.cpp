@@ -0,0 +1,99 @@
+// fast_math.h 정확도 검사.
+// fastExp를 std::exp(double 기준)와 비교해 [kFastExpMin, kFastExpMax]의 float를 훑고, 최대 상대 오차가
+// kFastExpMaxRelError를 넘거나 범위 밖 처리(0 / 포화)가 틀리면 종료 코드 1을 돌려준다.
+// Doppler likelihood도 커널이 쓰는 범위에서 기존 식(std::exp)과의 최대 절대 오차를 확인한다.
+//
+// 사용법: dogm_math_check [stride=16]   (stride: 훑을 때 건너뛰는 float 비트 패턴 간격, 1이면 전부)
+#include "dogm/fast_math.h"
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+
+using namespace dogm;
+
+namespace {
+
+float fromBits(uint32_t bits) {
+    float f;
+    std::memcpy(&f, &bits, sizeof(f));
+    return f;
+}
+
+uint32_t toBits(float f) {
+    uint32_t bits;
+    std::memcpy(&bits, &f, sizeof(bits));
+    return bits;
+}
+
+struct ErrorStats {
+    double max_rel_error = 0.0;
+    float worst_x = 0.0f;
+    long long count = 0;
+};
+
+// 같은 부호의 float 구간 [a, b]를 비트 패턴 순서로 훑는다
+void sweep(float a, float b, uint32_t stride, ErrorStats& stats) {
+    uint32_t lo = toBits(a), hi = toBits(b);
+    if (lo > hi) std::swap(lo, hi);
+    for (uint64_t bits = lo; bits <= hi; bits += stride) {
+        const float x = fromBits(static_cast<uint32_t>(bits));
+        const double reference = std::exp(static_cast<double>(x));
+        const double error = std::abs(fastExp(x) - reference) / reference;
+        if (error > stats.max_rel_error) {
+            stats.max_rel_error = error;
+            stats.worst_x = x;
+        }
+        ++stats.count;
+    }
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const uint32_t stride = (argc > 1) ? static_cast<uint32_t>(std::max(1, std::atoi(argv[1]))) : 16;
+    int failures = 0;
+
+    ErrorStats exp_stats;
+    sweep(-0.0f, kFastExpMin, stride, exp_stats);
+    sweep(0.0f, kFastExpMax, stride, exp_stats);
+    const bool exp_ok = exp_stats.max_rel_error <= kFastExpMaxRelError;
+    failures += !exp_ok;
+    std::cout << "fastExp over [" << kFastExpMin << ", " << kFastExpMax << "], " << exp_stats.count
+              << " samples: max rel error " << std::scientific << std::setprecision(3) << exp_stats.max_rel_error
+              << " at x = " << std::setprecision(9) << exp_stats.worst_x << " (bound " << std::setprecision(3)
+              << kFastExpMaxRelError << ")" << (exp_ok ? "" : "  FAIL") << std::endl;
+
+    // 범위 밖: 아래는 0, 위는 유한한 값으로 포화
+    const float inf = std::numeric_limits<float>::infinity();
+    const bool edges_ok = fastExp(-100.0f) == 0.0f && fastExp(-inf) == 0.0f && std::isfinite(fastExp(100.0f)) &&
+                          fastExp(100.0f) >= fastExp(kFastExpMax) && fastExp(0.0f) == 1.0f;
+    failures += !edges_ok;
+    std::cout << "fastExp out of range: exp(-100) = " << fastExp(-100.0f) << ", exp(100) = " << fastExp(100.0f)
+              << ", exp(0) = " << fastExp(0.0f) << (edges_ok ? "" : "  FAIL") << std::endl;
+
+    // Doppler likelihood: 커널이 쓰는 범위의 속도 차이와 분산에서 기존 식과의 최대 절대 오차
+    double max_likelihood_error = 0.0;
+    for (int vi = -400; vi <= 400; ++vi) {
+        const float vx = vi * 0.05f;
+        const float vy = -0.5f * vx;
+        for (float var : {0.01f, 0.04f, 0.1f, 0.25f, 1.0f, 4.0f}) {
+            for (float radial_velocity : {-8.0f, -1.0f, 0.0f, 2.5f}) {
+                const float los_x = 0.6f, los_y = 0.8f;
+                const float diff = vx * los_x + vy * los_y - radial_velocity;
+                const double reference = std::exp(-0.5 * diff * diff / var);
+                const float fast = dopplerLikelihood(vx, vy, los_x, los_y, radial_velocity, -0.5f / var);
+                max_likelihood_error = std::max(max_likelihood_error, std::abs(fast - reference));
+            }
+        }
+    }
+    const double kLikelihoodBound = 1e-6;
+    const bool likelihood_ok = max_likelihood_error <= kLikelihoodBound;
+    failures += !likelihood_ok;
+    std::cout << "dopplerLikelihood: max abs error " << max_likelihood_error << " (bound " << kLikelihoodBound
+              << ")" << (likelihood_ok ? "" : "  FAIL") << std::endl;
+
+    std::cout << std::endl << (failures == 0 ? "OK" : "FAIL") << std::endl;
+    return failures == 0 ? 0 : 1;
+}
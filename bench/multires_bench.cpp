@@ -0,0 +1,124 @@
+// 한 장의 세밀한 그리드 vs 동심 다해상도 그리드 (DOGMMultiRes).
+// 같은 합성 프레임으로 셀 수, 갱신한 셀 수, updateGrid 시간을 비교하고, 결과를 sampleGrid로
+// 같은 해상도에 다시 샘플링해 single 대비 점유 차이를 출력한다.
+//
+// 사용법: dogm_multires_bench [outer_size_m=60] [particles=400000] [frames=10]
+#include "bench_scene.h"
+#include "bench_util.h"
+#include "dogm/dogm_multires.h"
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+using namespace dogm;
+using namespace dogm::bench;
+
+namespace {
+
+struct RunResult {
+    int cells = 0;
+    double active_cells = 0.0;   // 프레임 평균
+    double update_ms = 0.0;      // 프레임 평균 (첫 프레임 제외)
+    std::vector<GridSample> samples;
+};
+
+float pignisticOf(const GridSample& sample) {
+    return sample.occ_mass + 0.5f * (1.0f - sample.occ_mass - sample.free_mass);
+}
+
+RunResult run(const DOGMMultiRes::Params& params, const std::vector<SensorFrame>& frames, float sample_resolution,
+              float outer_size) {
+    DOGMMultiRes grid(params);
+    RunResult result;
+    result.cells = grid.getCellCount();
+    for (size_t f = 0; f < frames.size(); ++f) {
+        auto start = std::chrono::steady_clock::now();
+        grid.updateGrid(frames[f], 0.1f);
+        const double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        if (f > 0) result.update_ms += ms;
+        result.active_cells += grid.getActiveCellCount();
+    }
+    result.update_ms /= std::max<size_t>(frames.size() - 1, 1);
+    result.active_cells /= frames.size();
+    grid.sampleGrid(sample_resolution, outer_size, result.samples);
+    return result;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const float outer_size = (argc > 1) ? static_cast<float>(std::atof(argv[1])) : 60.0f;
+    const int particles = (argc > 2) ? std::atoi(argv[2]) : 400000;
+    const int frame_count = std::max((argc > 3) ? std::atoi(argv[3]) : 10, 2);
+    const float fine_resolution = 0.1f;
+    const float sample_resolution = 0.4f;
+
+    SceneConfig config;
+    config.beam_count = 1080;
+    config.radar_count = 300;
+    std::vector<SensorFrame> frames;
+    for (int f = 0; f < frame_count; ++f) {
+        frames.push_back(makeSyntheticFrame(config, outer_size, f + 1));
+    }
+
+    DOGMMultiRes::Params single;
+    single.grid.new_born_particle_count = particles / 10;
+    single.levels = {{outer_size, fine_resolution, particles, particles / 10}};
+
+    // 창이 두 배씩 넓어지고 해상도는 level마다 두 배씩 성기다 (level마다 셀 수가 같다).
+    // 파티클은 (1) 총 수를 같게 level마다 나누거나 (2) 셀당 파티클 수를 single과 같게 둔다.
+    auto make_multires = [&](int level_particles) {
+        DOGMMultiRes::Params params;
+        params.grid = single.grid;
+        params.levels = {{outer_size / 4, fine_resolution, level_particles, level_particles / 10},
+                         {outer_size / 2, fine_resolution * 2, level_particles, level_particles / 10},
+                         {outer_size, fine_resolution * 4, level_particles, level_particles / 10}};
+        return params;
+    };
+
+    std::cout << "outer " << outer_size << " m, particles " << particles << ", frames " << frame_count
+              << ", threads " << omp_get_max_threads() << std::endl << std::endl;
+
+    const RunResult a = run(single, frames, sample_resolution, outer_size);
+    const RunResult b = run(make_multires(particles / 3), frames, sample_resolution, outer_size);
+    const RunResult c = run(make_multires(particles / 16), frames, sample_resolution, outer_size);
+
+    std::cout << std::setw(34) << "" << std::setw(10) << "cells" << std::setw(14) << "active cells"
+              << std::setw(12) << "update ms" << std::setw(12) << "speedup" << std::setw(22) << "mean |d pignistic|"
+              << std::endl;
+    auto print_row = [&](const char* name, const RunResult& r) {
+        // sampleGrid 결과의 pignistic 차이 (single 대비)
+        double diff = 0.0;
+        for (size_t i = 0; i < a.samples.size(); ++i) {
+            diff += std::abs(pignisticOf(a.samples[i]) - pignisticOf(r.samples[i]));
+        }
+        std::cout << std::fixed << std::setw(34) << name << std::setw(10) << r.cells << std::setprecision(0)
+                  << std::setw(14) << r.active_cells << std::setprecision(2) << std::setw(12) << r.update_ms
+                  << std::setw(11) << a.update_ms / r.update_ms << "x" << std::setprecision(4) << std::setw(22)
+                  << diff / std::max<size_t>(a.samples.size(), 1) << std::endl;
+    };
+    print_row("single 0.1 m", a);
+    print_row("multires, same particles", b);
+    print_row("multires, same particles/cell", c);
+    std::cout << std::endl;
+
+    // level 0 영역과 바깥 고리를 나눠 본 차이 (같은 총 파티클 수)
+    double diff_inner = 0.0, diff_outer = 0.0;
+    int count_inner = 0, count_outer = 0;
+    for (size_t i = 0; i < a.samples.size(); ++i) {
+        const double d = std::abs(pignisticOf(a.samples[i]) - pignisticOf(b.samples[i]));
+        if (b.samples[i].level == 0) {
+            diff_inner += d;
+            ++count_inner;
+        } else {
+            diff_outer += d;
+            ++count_outer;
+        }
+    }
+    std::cout << "sampleGrid at " << std::setprecision(1) << sample_resolution << " m, mean |d pignistic| vs single: "
+              << std::setprecision(4) << "level 0 area " << diff_inner / std::max(count_inner, 1)
+              << ", outer rings " << diff_outer / std::max(count_outer, 1) << std::endl;
+    return 0;
+}
@@ -0,0 +1,129 @@
+// TXT 센서 로그 파싱 처리량 벤치마크 (lines/sec): stringstream vs from_chars 파서 vs 병렬 chunk 파싱
+#include "text_parse.h"
+#include <omp.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace dogm;
+
+namespace {
+
+// RadarMap_v2.txt 형식: timestamp x y velocity snr
+std::string makeSyntheticLog(size_t line_count) {
+    std::string text;
+    text.reserve(line_count * 32);
+    char line[96];
+    for (size_t i = 0; i < line_count; ++i) {
+        int n = std::snprintf(line, sizeof(line), "%.2f %.3f %.3f %.3f %.1f\n",
+                              (i / 32) * 0.05, (i % 97) * 0.013 - 0.6, (i % 89) * 0.011 - 0.5,
+                              (i % 13) * 0.1 - 0.6, 5.0 + (i % 40));
+        text.append(line, n);
+    }
+    return text;
+}
+
+std::string readFile(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    std::stringstream ss;
+    ss << file.rdbuf();
+    return ss.str();
+}
+
+template<typename F>
+double bestSeconds(int repeats, F&& f) {
+    double best = 1e30;
+    for (int r = 0; r < repeats; ++r) {
+        auto start = std::chrono::high_resolution_clock::now();
+        f();
+        auto end = std::chrono::high_resolution_clock::now();
+        best = std::min(best, std::chrono::duration<double>(end - start).count());
+    }
+    return best;
+}
+
+size_t parseStringstream(const std::string& text, double& checksum) {
+    std::istringstream input(text);
+    std::string line;
+    size_t lines = 0;
+    while (std::getline(input, line)) {
+        std::stringstream ss(line);
+        double t, x, y, v, snr;
+        if (ss >> t >> x >> y >> v >> snr) {
+            checksum += x + y + v;
+            ++lines;
+        }
+    }
+    return lines;
+}
+
+size_t parseChunk(const TextChunk& chunk, double& checksum) {
+    LineCursor cursor(chunk);
+    const char* line_begin;
+    const char* line_end;
+    size_t lines = 0;
+    while (cursor.nextLine(line_begin, line_end)) {
+        FieldParser fields(line_begin, line_end);
+        double t, x, y, v, snr;
+        if (fields.next(t) && fields.next(x) && fields.next(y) && fields.next(v) && fields.next(snr)) {
+            checksum += x + y + v;
+            ++lines;
+        }
+    }
+    return lines;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    // 인자: [log 파일 경로 | 합성 줄 수]
+    std::string text;
+    if (argc > 1 && std::ifstream(argv[1]).good()) {
+        text = readFile(argv[1]);
+    } else {
+        text = makeSyntheticLog(argc > 1 ? std::stoul(argv[1]) : 2000000);
+    }
+    const char* begin = text.data();
+    const char* end = text.data() + text.size();
+    const int repeats = 3;
+
+    std::cout << "input " << text.size() / (1024.0 * 1024.0) << " MiB, threads " << omp_get_max_threads() << std::endl;
+
+    auto report = [](const char* name, size_t lines, double seconds, double checksum) {
+        std::cout << std::left << std::setw(24) << name << std::right << std::fixed
+                  << std::setw(14) << std::setprecision(0) << lines / seconds << " lines/s"
+                  << std::setw(12) << std::setprecision(2) << seconds * 1e3 << " ms"
+                  << "  (checksum " << std::setprecision(3) << checksum << ")" << std::endl;
+    };
+
+    size_t lines = 0;
+    double checksum = 0.0;
+    double seconds = bestSeconds(repeats, [&]() { checksum = 0.0; lines = parseStringstream(text, checksum); });
+    report("getline+stringstream", lines, seconds, checksum);
+
+    seconds = bestSeconds(repeats, [&]() { checksum = 0.0; lines = parseChunk({begin, end}, checksum); });
+    report("from_chars serial", lines, seconds, checksum);
+
+    seconds = bestSeconds(repeats, [&]() {
+        std::vector<TextChunk> chunks = splitIntoChunks(begin, end, omp_get_max_threads());
+        size_t total_lines = 0;
+        double total_checksum = 0.0;
+        #pragma omp parallel for reduction(+:total_lines, total_checksum) schedule(static, 1)
+        for (int c = 0; c < static_cast<int>(chunks.size()); ++c) {
+            double local = 0.0;
+            total_lines += parseChunk(chunks[c], local);
+            total_checksum += local;
+        }
+        lines = total_lines;
+        checksum = total_checksum;
+    });
+    report("from_chars chunked", lines, seconds, checksum);
+
+    return 0;
+}
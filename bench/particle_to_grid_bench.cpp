@@ -0,0 +1,130 @@
+// particleToGrid 벤치마크: 기존 std::sort 경로 vs counting sort
+#include "dogm/dogm.h"
+#include "dogm/kernel/update.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <iomanip>
+#include <numeric>
+#include <vector>
+
+using namespace dogm;
+
+namespace {
+
+// 이전 구현 (std::sort + 임시 ParticlesSoA 할당 후 복사)
+void particleToGridSortReference(ParticlesSoA& particles, std::vector<GridCell>& grid_cells,
+                                 std::vector<float>& weight_array) {
+    std::vector<int> p_indices(particles.size());
+    std::iota(p_indices.begin(), p_indices.end(), 0);
+    std::sort(p_indices.begin(), p_indices.end(),
+        [&](int a, int b) {
+            return particles.grid_cell_idx[a] < particles.grid_cell_idx[b];
+        });
+
+    ParticlesSoA sorted_particles;
+    sorted_particles.resize(particles.size());
+    #pragma omp parallel for
+    for (size_t i = 0; i < particles.size(); ++i) {
+        sorted_particles.copyStateFrom(i, particles, p_indices[i]);
+        sorted_particles.grid_cell_idx[i] = particles.grid_cell_idx[p_indices[i]];
+        sorted_particles.weight[i] = particles.weight[p_indices[i]];
+        sorted_particles.associated[i] = particles.associated[p_indices[i]];
+    }
+    particles = sorted_particles;
+
+    #pragma omp parallel for
+    for (size_t i = 0; i < grid_cells.size(); ++i) {
+        grid_cells[i].start_idx = -1;
+        grid_cells[i].end_idx = -1;
+    }
+    if (particles.size() == 0) return;
+
+    grid_cells[particles.grid_cell_idx[0]].start_idx = 0;
+    for (size_t i = 1; i < particles.size(); ++i) {
+        weight_array[i-1] = particles.weight[i-1];
+        int prev_cell_idx = particles.grid_cell_idx[i-1];
+        int cell_idx = particles.grid_cell_idx[i];
+        if (cell_idx != prev_cell_idx) {
+            grid_cells[prev_cell_idx].end_idx = i - 1;
+            grid_cells[cell_idx].start_idx = i;
+        }
+    }
+    grid_cells[particles.grid_cell_idx.back()].end_idx = particles.size() - 1;
+    weight_array.back() = particles.weight.back();
+}
+
+void makeParticles(ParticlesSoA& particles, int count, int grid_size, unsigned int seed) {
+    RandomGenerator rng(seed);
+    particles.resize(count);
+    for (int i = 0; i < count; ++i) {
+        float u[4];
+        rng.uniform4(RandomStream::InitParticles, i, u);
+        float x = u[0] * grid_size;
+        float y = u[1] * grid_size;
+        particles.setState(i, x, y, u[2], u[3]);
+        particles.weight[i] = 1.0f / count;
+        particles.associated[i] = 0;
+        particles.grid_cell_idx[i] = static_cast<int>(y) * grid_size + static_cast<int>(x);
+    }
+}
+
+template<typename F>
+double timeMs(int repeats, F&& f) {
+    double best = 1e30;
+    for (int r = 0; r < repeats; ++r) {
+        auto start = std::chrono::high_resolution_clock::now();
+        f();
+        auto end = std::chrono::high_resolution_clock::now();
+        best = std::min(best, std::chrono::duration<double, std::milli>(end - start).count());
+    }
+    return best;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const int grid_size = (argc > 1) ? std::atoi(argv[1]) : 300;
+    const int repeats = (argc > 2) ? std::atoi(argv[2]) : 10;
+    const int cell_count = grid_size * grid_size;
+
+    std::cout << "grid " << grid_size << "x" << grid_size << ", threads " << omp_get_max_threads()
+              << ", best of " << repeats << std::endl;
+    std::cout << std::setw(10) << "particles" << std::setw(14) << "std::sort ms"
+              << std::setw(16) << "counting ms" << std::setw(10) << "speedup" << std::setw(8) << "match" << std::endl;
+
+    for (int count : {20000, 200000, 1000000}) {
+        ParticlesSoA input;
+        makeParticles(input, count, grid_size, 42);
+
+        std::vector<GridCell> cells_ref(cell_count), cells_new(cell_count);
+        std::vector<float> weights_ref(count), weights_new(count);
+        ParticlesSoA work, sorted;
+        std::vector<int> histogram;
+        ActiveCells occupied;
+
+        double ref_ms = timeMs(repeats, [&]() {
+            work = input;
+            particleToGridSortReference(work, cells_ref, weights_ref);
+        });
+        double copy_ms = timeMs(repeats, [&]() { work = input; });
+
+        double new_ms = timeMs(repeats, [&]() {
+            kernel::particleToGrid(input, sorted, cells_new, weights_new, histogram, occupied);
+        });
+
+        bool match = true;
+        for (int c = 0; c < cell_count; ++c) {
+            match &= cells_ref[c].start_idx == cells_new[c].start_idx && cells_ref[c].end_idx == cells_new[c].end_idx;
+        }
+
+        // 기준 경로의 입력 복사 시간은 제외
+        ref_ms = std::max(ref_ms - copy_ms, 0.0);
+        std::cout << std::setw(10) << count << std::fixed << std::setprecision(3)
+                  << std::setw(14) << ref_ms << std::setw(16) << new_ms
+                  << std::setw(9) << std::setprecision(1) << ref_ms / new_ms << "x"
+                  << std::setw(8) << (match ? "yes" : "NO") << std::endl;
+    }
+    return 0;
+}
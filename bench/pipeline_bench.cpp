@@ -0,0 +1,94 @@
+// 동기 updateGrid vs DOGMPipeline (측정 그리드 build를 prediction 및 이전 프레임과 겹침).
+// 프레임마다 결과(셀 질량, 파티클)를 비교해 두 방식이 같은지도 확인한다.
+//
+// 사용법: dogm_pipeline_bench [grid_cells_per_side=400] [particles=200000] [frames=20] [measurement_threads=1]
+#include "bench_scene.h"
+#include "dogm/dogm_pipeline.h"
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+using namespace dogm;
+using namespace dogm::bench;
+
+namespace {
+
+struct RunResult {
+    double frame_ms = 0.0;
+    std::vector<double> checksums;
+};
+
+RunResult runSynchronous(const DOGM::Params& params, const std::vector<SensorFrame>& inputs, float dt) {
+    DOGM dogm(params);
+    RunResult result;
+    auto start = std::chrono::steady_clock::now();
+    std::chrono::duration<double, std::milli> checksum_time(0);
+    for (const SensorFrame& frame : inputs) {
+        dogm.updateGrid(frame, dt);
+        auto before = std::chrono::steady_clock::now();
+        result.checksums.push_back(gridChecksum(dogm));
+        checksum_time += std::chrono::steady_clock::now() - before;
+    }
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    result.frame_ms = (std::chrono::duration<double, std::milli>(elapsed) - checksum_time).count() / inputs.size();
+    return result;
+}
+
+RunResult runPipelined(const DOGM::Params& params, const std::vector<SensorFrame>& inputs, float dt,
+                       int measurement_threads) {
+    DOGMPipeline pipeline(params, measurement_threads);
+    RunResult result;
+    std::chrono::duration<double, std::milli> checksum_time(0);
+    pipeline.setFrameCallback([&](const DOGM& dogm) {
+        auto before = std::chrono::steady_clock::now();
+        result.checksums.push_back(gridChecksum(dogm));
+        checksum_time += std::chrono::steady_clock::now() - before;
+    });
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::future<void>> done;
+    for (const SensorFrame& frame : inputs) {
+        done.push_back(pipeline.submitFrame(frame, dt));
+    }
+    for (auto& f : done) f.get();
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    result.frame_ms = (std::chrono::duration<double, std::milli>(elapsed) - checksum_time).count() / inputs.size();
+    return result;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    SceneConfig config;
+    config.grid_cells_per_side = (argc > 1) ? std::atoi(argv[1]) : 400;
+    config.particle_count = (argc > 2) ? std::atoi(argv[2]) : 200000;
+    const int frames = (argc > 3) ? std::atoi(argv[3]) : 20;
+    const int measurement_threads = (argc > 4) ? std::atoi(argv[4]) : 1;
+    const float dt = 0.1f;
+
+    std::cout << "grid " << config.grid_cells_per_side << "x" << config.grid_cells_per_side
+              << ", particles " << config.particle_count << ", frames " << frames
+              << ", threads " << omp_get_max_threads() << ", measurement threads " << measurement_threads
+              << std::endl << std::endl;
+    std::cout << std::left << std::setw(12) << "scene" << std::right << std::setw(12) << "sync ms"
+              << std::setw(14) << "pipeline ms" << std::setw(10) << "speedup" << std::setw(10) << "match"
+              << std::endl;
+
+    for (bool follow_ego : {false, true}) {
+        DOGM::Params params = sceneParams(config);
+        params.follow_ego = follow_ego;
+
+        const std::vector<SensorFrame> inputs = follow_ego ? makeMovingEgoFrames(config, params.size, frames)
+                                                           : makeSyntheticFrames(config, params.size, frames);
+
+        RunResult sync = runSynchronous(params, inputs, dt);
+        RunResult piped = runPipelined(params, inputs, dt, measurement_threads);
+        const bool match = sync.checksums == piped.checksums;
+        std::cout << std::left << std::setw(12) << (follow_ego ? "follow_ego" : "static") << std::right
+                  << std::fixed << std::setprecision(2) << std::setw(12) << sync.frame_ms << std::setw(14)
+                  << piped.frame_ms << std::setw(9) << sync.frame_ms / piped.frame_ms << "x" << std::setw(10)
+                  << (match ? "yes" : "NO") << std::endl;
+    }
+    return 0;
+}
@@ -1,7 +1,9 @@
 #include "data_loader.h"
-#include <fstream>
-#include <sstream>
+#include "mapped_file.h"
+#include "text_parse.h"
+#include <omp.h>
 #include <iostream>
+#include <memory>
 #include <stdexcept>
 #include <vector>
 #include <algorithm>
@@ -11,7 +13,7 @@
 
 namespace dogm {
 
-RealDataLoader::RealDataLoader(const std::string& data_path) {
+RealDataLoader::RealDataLoader(const std::string& data_path) : ego_poses(data_path) {
     std::cout << "Loading data from path: " << data_path << std::endl;
     
     std::string lidar_file = data_path + "/LiDARMap_v2.txt";
@@ -37,41 +39,91 @@ RealDataLoader::RealDataLoader(const std::string& data_path) {
     std::cout << "Found " << total_frames << " frames." << std::endl;
 }
 
-void RealDataLoader::loadLidarData(const std::string& filename) {
-    std::ifstream file(filename);
-    if (!file.is_open()) {
-        throw std::runtime_error("Cannot open LiDAR file: " + filename);
+namespace {
+
+struct LidarRecord {
+    double timestamp;
+    float angle;
+    float range;
+};
+
+struct RadarRecord {
+    double timestamp;
+    RadarDetection detection;
+};
+
+// 파일을 mmap하고 개행 경계로 나눈 chunk를 병렬로 파싱한다. 결과는 chunk(= 파일) 순서를 유지한다.
+template<typename Record, typename ParseLine>
+std::vector<std::vector<Record>> parseFileChunked(const std::string& filename, const std::string& kind,
+                                                  ParseLine parse_line) {
+    std::unique_ptr<MappedFile> file;
+    try {
+        file.reset(new MappedFile(filename));
+    } catch (const std::runtime_error&) {
+        throw std::runtime_error("Cannot open " + kind + " file: " + filename);
     }
-    
-    std::string line;
-    while (std::getline(file, line)) {
-        std::stringstream ss(line);
-        double timestamp, x, y, intensity;
-        if (ss >> timestamp >> x >> y >> intensity) {
-            double angle = std::atan2(y, x);
-            double range = std::sqrt(x*x + y*y);
-            lidar_data[timestamp].angles.push_back(angle);
-            lidar_data[timestamp].ranges.push_back(range);
+
+    std::vector<TextChunk> chunks = splitIntoChunks(file->data(), file->data() + file->size(),
+                                                    omp_get_max_threads());
+    std::vector<std::vector<Record>> results(chunks.size());
+
+    #pragma omp parallel for schedule(static, 1)
+    for (int c = 0; c < static_cast<int>(chunks.size()); ++c) {
+        LineCursor cursor(chunks[c]);
+        const char* line_begin;
+        const char* line_end;
+        Record record;
+        while (cursor.nextLine(line_begin, line_end)) {
+            if (parse_line(line_begin, line_end, record)) {
+                results[c].push_back(record);
+            }
         }
     }
+    return results;
 }
 
-void RealDataLoader::loadRadarData(const std::string& filename) {
-    std::ifstream file(filename);
-    if (!file.is_open()) {
-        throw std::runtime_error("Cannot open Radar file: " + filename);
+} // namespace
+
+void RealDataLoader::loadLidarData(const std::string& filename) {
+    auto chunks = parseFileChunked<LidarRecord>(filename, "LiDAR",
+        [](const char* begin, const char* end, LidarRecord& record) {
+            FieldParser fields(begin, end);
+            double x, y, intensity;
+            if (!(fields.next(record.timestamp) && fields.next(x) && fields.next(y) && fields.next(intensity))) {
+                return false;
+            }
+            record.angle = std::atan2(y, x);
+            record.range = std::sqrt(x*x + y*y);
+            return true;
+        });
+
+    for (const auto& records : chunks) {
+        for (const auto& record : records) {
+            auto& scan = lidar_data[record.timestamp];
+            scan.angles.push_back(record.angle);
+            scan.ranges.push_back(record.range);
+        }
     }
-    
-    std::string line;
-    while (std::getline(file, line)) {
-        std::stringstream ss(line);
-        double timestamp, x, y, velocity, snr;
-        if (ss >> timestamp >> x >> y >> velocity >> snr) {
-            RadarDetection detection;
-            detection.position = Eigen::Vector2f(x, y);
-            detection.radial_velocity = velocity;
-            detection.snr = snr; // snr 값을 저장하도록 수정
-            radar_data[timestamp].push_back(detection);
+}
+
+void RealDataLoader::loadRadarData(const std::string& filename) {
+    auto chunks = parseFileChunked<RadarRecord>(filename, "Radar",
+        [](const char* begin, const char* end, RadarRecord& record) {
+            FieldParser fields(begin, end);
+            double x, y, velocity, snr;
+            if (!(fields.next(record.timestamp) && fields.next(x) && fields.next(y) &&
+                  fields.next(velocity) && fields.next(snr))) {
+                return false;
+            }
+            record.detection.position = Eigen::Vector2f(x, y);
+            record.detection.radial_velocity = velocity;
+            record.detection.snr = snr;
+            return true;
+        });
+
+    for (const auto& records : chunks) {
+        for (const auto& record : records) {
+            radar_data[record.timestamp].push_back(record.detection);
         }
     }
 }
@@ -99,9 +151,7 @@ SensorFrame RealDataLoader::getNextFrame() {
         frame.radar = radar_data[timestamp];
     }
 
-    // Ego pose (고정값 사용)
-    frame.ego_pose = {10.0f, 1.0f};
-    frame.ego_yaw = M_PI / 2.0;
+    ego_poses.lookup(timestamp, frame.ego_pose, frame.ego_yaw);
 
     current_frame_index++;
     return frame;
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "dogm/dogm_types.h"
+#include "ego_pose.h"
 #include <string>
 #include <vector>
 #include <map>
@@ -22,9 +23,10 @@ private:
     void loadLidarData(const std::string& filename);
     void loadRadarData(const std::string& filename);
     
-    std::map<double, LidarScan> lidar_data;
+    std::map<double, LidarMeasurement> lidar_data;
     std::map<double, std::vector<RadarDetection>> radar_data;
     std::vector<double> timestamps;
+    EgoPoseTrack ego_poses;
     
     size_t current_frame_index = 0;
     size_t total_frames = 0;
@@ -0,0 +1,55 @@
+#include "ego_pose.h"
+#include "mapped_file.h"
+#include "text_parse.h"
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+
+namespace dogm {
+
+EgoPoseTrack::EgoPoseTrack(const std::string& data_path) {
+    const std::string filename = data_path + "/EgoPose.txt";
+    if (!std::ifstream(filename).good()) return;
+
+    MappedFile file(filename);
+    LineCursor lines(file.data(), file.data() + file.size());
+    const char* line_begin;
+    const char* line_end;
+    while (lines.nextLine(line_begin, line_end)) {
+        FieldParser fields(line_begin, line_end);
+        Sample sample;
+        if (fields.next(sample.timestamp) && fields.next(sample.x) && fields.next(sample.y) && fields.next(sample.yaw)) {
+            samples.push_back(sample);
+        }
+    }
+    std::cout << "Loaded " << samples.size() << " ego poses from " << filename << std::endl;
+}
+
+void EgoPoseTrack::lookup(double timestamp, Vec2& pose, float& yaw) const {
+    if (samples.empty()) {
+        // Ego pose (고정값 사용)
+        pose = {10.0f, 1.0f};
+        yaw = M_PI / 2.0;
+        return;
+    }
+
+    auto next = std::lower_bound(samples.begin(), samples.end(), timestamp,
+                                 [](const Sample& s, double t) { return s.timestamp < t; });
+    if (next == samples.begin() || next == samples.end()) {
+        const Sample& s = (next == samples.end()) ? samples.back() : *next;
+        pose = {s.x, s.y};
+        yaw = s.yaw;
+        return;
+    }
+
+    const Sample& a = *(next - 1);
+    const Sample& b = *next;
+    const float t = static_cast<float>((timestamp - a.timestamp) / (b.timestamp - a.timestamp));
+    pose = {a.x + (b.x - a.x) * t, a.y + (b.y - a.y) * t};
+    // yaw는 최단 각도 방향으로 보간
+    float dyaw = std::remainder(b.yaw - a.yaw, 2.0f * static_cast<float>(M_PI));
+    yaw = a.yaw + dyaw * t;
+}
+
+} // namespace dogm
@@ -0,0 +1,31 @@
+#pragma once
+
+#include "dogm/dogm_types.h"
+#include <string>
+#include <vector>
+
+namespace dogm {
+
+// 데이터 디렉터리의 선택적 EgoPose.txt ("timestamp x y yaw", 타임스탬프 오름차순)를 읽는다.
+// 파일이 없으면 이전과 같은 고정 pose ({10, 1}, yaw = pi/2)를 반환한다.
+class EgoPoseTrack {
+public:
+    explicit EgoPoseTrack(const std::string& data_path);
+
+    // timestamp 시점의 pose. 샘플 사이는 선형 보간, 범위 밖은 가장 가까운 샘플을 사용한다.
+    void lookup(double timestamp, Vec2& pose, float& yaw) const;
+
+    bool empty() const { return samples.empty(); }
+
+private:
+    struct Sample {
+        double timestamp;
+        float x;
+        float y;
+        float yaw;
+    };
+
+    std::vector<Sample> samples;
+};
+
+} // namespace dogm
@@ -0,0 +1,134 @@
+#include "frame_stream.h"
+#include "text_parse.h"
+#include <cmath>
+#include <stdexcept>
+
+namespace dogm {
+
+StreamingDataLoader::StreamingDataLoader(const std::string& data_path, size_t prefetch_frames)
+    : lidar_file(data_path + "/LiDARMap_v2.txt"),
+      radar_file(data_path + "/RadarMap_v2.txt"),
+      ego_poses(data_path),
+      ring(prefetch_frames) {
+    if (!lidar_file.is_open()) {
+        throw std::runtime_error("Cannot open LiDAR file: " + data_path + "/LiDARMap_v2.txt");
+    }
+    if (!radar_file.is_open()) {
+        throw std::runtime_error("Cannot open Radar file: " + data_path + "/RadarMap_v2.txt");
+    }
+    producer = std::thread(&StreamingDataLoader::producerLoop, this);
+}
+
+StreamingDataLoader::~StreamingDataLoader() {
+    stop_requested.store(true, std::memory_order_relaxed);
+    ring.close();  // 가득 찬 ring에서 기다리는 producer를 깨운다
+    if (producer.joinable()) {
+        producer.join();
+    }
+}
+
+bool StreamingDataLoader::readLidarScan(double& timestamp, LidarMeasurement& scan) {
+    scan.ranges.clear();
+    scan.angles.clear();
+    bool has_scan = false;
+
+    while (true) {
+        if (lidar_pending.empty() && !std::getline(lidar_file, lidar_pending)) break;
+
+        FieldParser fields(lidar_pending.data(), lidar_pending.data() + lidar_pending.size());
+        double t, x, y, intensity;
+        if (!(fields.next(t) && fields.next(x) && fields.next(y) && fields.next(intensity))) {
+            lidar_pending.clear();
+            continue;
+        }
+        if (has_scan && t != timestamp) break; // 다음 스캔의 첫 줄은 남겨 둔다
+
+        timestamp = t;
+        has_scan = true;
+        scan.angles.push_back(std::atan2(y, x));
+        scan.ranges.push_back(std::sqrt(x*x + y*y));
+        lidar_pending.clear();
+    }
+    return has_scan;
+}
+
+bool StreamingDataLoader::readRadarScan(double& timestamp, std::vector<RadarDetection>& detections) {
+    detections.clear();
+    bool has_scan = false;
+
+    while (true) {
+        if (radar_pending.empty() && !std::getline(radar_file, radar_pending)) break;
+
+        FieldParser fields(radar_pending.data(), radar_pending.data() + radar_pending.size());
+        double t, x, y, velocity, snr;
+        if (!(fields.next(t) && fields.next(x) && fields.next(y) && fields.next(velocity) && fields.next(snr))) {
+            radar_pending.clear();
+            continue;
+        }
+        if (has_scan && t != timestamp) break;
+
+        timestamp = t;
+        has_scan = true;
+        RadarDetection detection;
+        detection.position = Eigen::Vector2f(x, y);
+        detection.radial_velocity = velocity;
+        detection.snr = snr;
+        detections.push_back(detection);
+        radar_pending.clear();
+    }
+    return has_scan;
+}
+
+void StreamingDataLoader::producerLoop() {
+    try {
+        double lidar_time = 0.0, radar_time = 0.0;
+        LidarMeasurement lidar_scan;
+        std::vector<RadarDetection> radar_scan;
+
+        bool has_lidar = readLidarScan(lidar_time, lidar_scan);
+        bool has_radar = readRadarScan(radar_time, radar_scan);
+
+        while (has_lidar && has_radar && !stop_requested.load(std::memory_order_relaxed)) {
+            if (lidar_time < radar_time) {
+                has_lidar = readLidarScan(lidar_time, lidar_scan);
+            } else if (radar_time < lidar_time) {
+                has_radar = readRadarScan(radar_time, radar_scan);
+            } else {
+                SensorFrame* slot = ring.waitWrite();
+                if (!slot) return;  // 소멸자의 close()
+
+                // swap으로 슬롯과 작업 버퍼의 용량을 순환시켜 재할당을 피한다.
+                slot->timestamp = lidar_time;
+                std::swap(slot->lidar, lidar_scan);
+                std::swap(slot->radar, radar_scan);
+                ego_poses.lookup(lidar_time, slot->ego_pose, slot->ego_yaw);
+                ring.commitWrite();
+
+                has_lidar = readLidarScan(lidar_time, lidar_scan);
+                has_radar = readRadarScan(radar_time, radar_scan);
+            }
+        }
+    } catch (...) {
+        producer_error = std::current_exception();
+    }
+    // producer_error는 close()의 mutex를 거쳐 consumer에 보인다
+    ring.close();
+}
+
+const SensorFrame* StreamingDataLoader::acquireFrame() {
+    if (const SensorFrame* frame = ring.waitRead()) {
+        return frame;
+    }
+    // close() 전에 커밋된 프레임은 모두 소비했다
+    if (producer_error) {
+        std::rethrow_exception(producer_error);
+    }
+    return nullptr;
+}
+
+void StreamingDataLoader::releaseFrame() {
+    ring.commitRead();
+    ++frames_consumed;
+}
+
+} // namespace dogm
@@ -0,0 +1,54 @@
+#pragma once
+
+#include "dogm/dogm_types.h"
+#include "ego_pose.h"
+#include "spsc_ring.h"
+#include <atomic>
+#include <exception>
+#include <fstream>
+#include <string>
+#include <thread>
+
+namespace dogm {
+
+// LiDAR/Radar TXT 파일을 타임스탬프 순으로 점진적으로 병합하는 스트리밍 로더.
+// 백그라운드 스레드가 고정 크기 ring buffer를 채우므로 메모리 사용량은 기록 길이와 무관하다.
+// 두 파일 모두 타임스탬프 오름차순이어야 하며, RealDataLoader와 같이 공통 타임스탬프만 프레임이 된다.
+class StreamingDataLoader {
+public:
+    explicit StreamingDataLoader(const std::string& data_path, size_t prefetch_frames = 32);
+    ~StreamingDataLoader();
+
+    StreamingDataLoader(const StreamingDataLoader&) = delete;
+    StreamingDataLoader& operator=(const StreamingDataLoader&) = delete;
+
+    // 다음 프레임을 기다려 반환한다. 스트림이 끝나면 nullptr.
+    // 반환된 프레임은 releaseFrame() 호출 전까지 유효하다.
+    const SensorFrame* acquireFrame();
+    void releaseFrame();
+
+    size_t getCurrentFrameIndex() const { return frames_consumed; }
+
+private:
+    void producerLoop();
+    bool readLidarScan(double& timestamp, LidarMeasurement& scan);
+    bool readRadarScan(double& timestamp, std::vector<RadarDetection>& detections);
+
+    std::ifstream lidar_file;
+    std::ifstream radar_file;
+
+    // 다음 타임스탬프의 첫 줄을 미리 읽어 둔다.
+    std::string lidar_pending;
+    std::string radar_pending;
+
+    EgoPoseTrack ego_poses;
+
+    SpscRing<SensorFrame> ring;
+    std::thread producer;
+    std::atomic<bool> stop_requested{false};
+    std::exception_ptr producer_error;
+
+    size_t frames_consumed = 0;
+};
+
+} // namespace dogm
@@ -0,0 +1,368 @@
+#include "grid_snapshot.h"
+#include <cstring>
+#include <stdexcept>
+
+namespace dogm {
+
+namespace {
+
+// 이보다 짧은 0 구간은 토큰을 새로 여는 대신 literal에 포함한다
+constexpr size_t kMinZeroRun = 4;
+
+// reader가 받아들이는 프레임 payload 상한 (grid_size 약 14600까지, 손상된 헤더의 거대한 할당 방지)
+constexpr uint64_t kMaxPayloadBytes = uint64_t(1) << 30;
+
+size_t payloadSize(size_t cells) { return cells * (sizeof(uint8_t) + 2 * sizeof(int16_t)); }
+
+// 빈 그리드: 점유 0.5 (128), 속도 0
+void fillBaseline(std::vector<uint8_t>& payload, size_t cells) {
+    payload.assign(payloadSize(cells), 0);
+    std::memset(payload.data(), 128, cells);
+}
+
+// 창이 (dx, dy) 셀 이동했을 때의 직전 프레임: out의 로컬 (x, y) = previous의 (x + dx, y + dy),
+// 창 밖에서 들어온 셀은 빈 그리드
+void shiftPayload(const std::vector<uint8_t>& previous, int dx, int dy, int grid_size,
+                  std::vector<uint8_t>& out) {
+    const size_t cells = static_cast<size_t>(grid_size) * grid_size;
+    fillBaseline(out, cells);
+    const int x_begin = std::max(0, -dx);
+    const int x_end = std::min(grid_size, grid_size - dx);
+    if (x_begin >= x_end) return;
+    const size_t width = x_end - x_begin;
+    for (int y = std::max(0, -dy); y < std::min(grid_size, grid_size - dy); ++y) {
+        const size_t dst = static_cast<size_t>(y) * grid_size + x_begin;
+        const size_t src = static_cast<size_t>(y + dy) * grid_size + x_begin + dx;
+        std::memcpy(&out[dst], &previous[src], width);
+        std::memcpy(&out[cells + 2 * dst], &previous[cells + 2 * src], width * sizeof(int16_t));
+        std::memcpy(&out[3 * cells + 2 * dst], &previous[3 * cells + 2 * src], width * sizeof(int16_t));
+    }
+}
+
+void putVarint(std::vector<uint8_t>& out, size_t value) {
+    while (value >= 0x80) {
+        out.push_back(static_cast<uint8_t>(value | 0x80));
+        value >>= 7;
+    }
+    out.push_back(static_cast<uint8_t>(value));
+}
+
+bool getVarint(const uint8_t*& p, const uint8_t* end, size_t& value) {
+    value = 0;
+    for (int shift = 0; p < end && shift < 64; shift += 7) {
+        const uint8_t byte = *p++;
+        value |= static_cast<size_t>(byte & 0x7F) << shift;
+        if (!(byte & 0x80)) return true;
+    }
+    return false;
+}
+
+// a[i..]와 b[i..]가 같은 바이트 수 (8바이트 단위로 먼저 비교)
+size_t equalRunLength(const uint8_t* a, const uint8_t* b, size_t i, size_t n) {
+    const size_t start = i;
+    while (i + 8 <= n) {
+        uint64_t x, y;
+        std::memcpy(&x, a + i, 8);
+        std::memcpy(&y, b + i, 8);
+        if (x != y) break;
+        i += 8;
+    }
+    while (i < n && a[i] == b[i]) ++i;
+    return i - start;
+}
+
+// current XOR reference를 zero-run RLE로 부호화한다
+void encodeXorRle(const uint8_t* current, const uint8_t* reference, size_t n, std::vector<uint8_t>& out) {
+    out.clear();
+    size_t i = 0;
+    while (i < n) {
+        const size_t zeros = equalRunLength(current, reference, i, n);
+        i += zeros;
+        const size_t literal_start = i;
+        while (i < n) {
+            if (current[i] != reference[i]) {
+                ++i;
+                continue;
+            }
+            const size_t run = equalRunLength(current, reference, i, n);
+            if (run >= kMinZeroRun || i + run == n) break;
+            i += run;
+        }
+        putVarint(out, zeros);
+        putVarint(out, i - literal_start);
+        for (size_t k = literal_start; k < i; ++k) {
+            out.push_back(current[k] ^ reference[k]);
+        }
+    }
+}
+
+// payload(기준 프레임)에 XOR 차이를 적용한다
+bool applyXorRle(const uint8_t* p, const uint8_t* end, std::vector<uint8_t>& payload) {
+    size_t i = 0;
+    while (p < end) {
+        size_t zeros, literals;
+        if (!getVarint(p, end, zeros) || !getVarint(p, end, literals)) return false;
+        if (zeros > payload.size() - i) return false;
+        i += zeros;
+        if (literals > payload.size() - i || literals > static_cast<size_t>(end - p)) return false;
+        for (size_t k = 0; k < literals; ++k) {
+            payload[i + k] ^= p[k];
+        }
+        i += literals;
+        p += literals;
+    }
+    return true;
+}
+
+} // namespace
+
+GridSnapshotWriter::GridSnapshotWriter(const std::string& filename, int grid_size, float resolution,
+                                       const GridSnapshotOptions& options)
+    : file(filename, std::ios::binary | std::ios::trunc), grid_size(grid_size), resolution(resolution),
+      options(options), ring(std::max<size_t>(options.queue_frames, 2)) {
+    if (!file.is_open()) {
+        throw std::runtime_error("Cannot open grid snapshot for writing: " + filename);
+    }
+    if (this->options.keyframe_interval == 0) this->options.keyframe_interval = 1;
+
+    // 헤더 자리는 close()에서 채운다.
+    GridSnapshotHeader header = {};
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    offset = sizeof(header);
+
+    const size_t cells = static_cast<size_t>(grid_size) * grid_size;
+    current.resize(payloadSize(cells));
+    reference.resize(payloadSize(cells));
+    encoded.reserve(payloadSize(cells) + 64);
+    fillBaseline(baseline, cells);
+
+    writer = std::thread(&GridSnapshotWriter::writerLoop, this);
+}
+
+GridSnapshotWriter::~GridSnapshotWriter() {
+    try {
+        close();
+    } catch (...) {
+    }
+}
+
+GridSnapshotFrame& GridSnapshotWriter::beginFrame() {
+    // 쓰기 스레드는 오류 뒤에도 큐를 비우므로 close() 전에는 항상 슬롯이 생긴다
+    pending = ring.waitWrite();
+    if (!pending) {
+        throw std::logic_error("GridSnapshotWriter::beginFrame after close()");
+    }
+    pending->resize(static_cast<size_t>(grid_size) * grid_size);
+    return *pending;
+}
+
+void GridSnapshotWriter::commitFrame() {
+    ring.commitWrite();
+    pending = nullptr;
+}
+
+void GridSnapshotWriter::writerLoop() {
+    // close() 전에 커밋된 프레임을 모두 쓴 뒤 nullptr로 끝난다
+    while (GridSnapshotFrame* frame = ring.waitRead()) {
+        // 오류 뒤에도 큐는 계속 비워 producer가 막히지 않게 한다
+        if (!writer_error) {
+            try {
+                writeFrame(*frame);
+            } catch (...) {
+                writer_error = std::current_exception();
+            }
+        }
+        ring.commitRead();
+    }
+}
+
+void GridSnapshotWriter::writeFrame(const GridSnapshotFrame& frame) {
+    const size_t cells = frame.occupancy.size();
+    uint8_t* out = current.data();
+    std::memcpy(out, frame.occupancy.data(), cells);
+    std::memcpy(out + cells, frame.velocity_x.data(), cells * sizeof(int16_t));
+    std::memcpy(out + 3 * cells, frame.velocity_y.data(), cells * sizeof(int16_t));
+
+    GridSnapshotFrameEntry entry = {};
+    entry.timestamp = frame.timestamp;
+    entry.data_offset = offset;
+    entry.origin_x = frame.origin_x;
+    entry.origin_y = frame.origin_y;
+
+    const uint8_t* data = current.data();
+    size_t size = current.size();
+    entry.flags = kGridFrameKeyframe;
+    if (options.compress) {
+        const bool keyframe = index.size() % options.keyframe_interval == 0;
+        const std::vector<uint8_t>* base = keyframe ? &baseline : &reference;
+        if (!keyframe) {
+            const int dx = frame.origin_x - index.back().origin_x;
+            const int dy = frame.origin_y - index.back().origin_y;
+            if (dx != 0 || dy != 0) {
+                shiftPayload(reference, dx, dy, grid_size, shifted);
+                base = &shifted;
+            }
+        }
+        encodeXorRle(current.data(), base->data(), current.size(), encoded);
+        // 압축이 이득이 없으면 raw로 쓴다 (raw 프레임은 그 자체로 keyframe)
+        if (encoded.size() < current.size()) {
+            data = encoded.data();
+            size = encoded.size();
+            entry.flags = kGridFrameRle | (keyframe ? kGridFrameKeyframe : 0);
+        }
+        std::swap(current, reference);
+    }
+    entry.data_size = static_cast<uint32_t>(size);
+
+    file.write(reinterpret_cast<const char*>(data), size);
+    if (!file) {
+        throw std::runtime_error("Failed to write grid snapshot frame");
+    }
+    offset += size;
+    index.push_back(entry);
+}
+
+void GridSnapshotWriter::close() {
+    if (closed) return;
+    closed = true;
+    ring.close();
+    writer.join();
+    if (writer_error) {
+        file.close();
+        std::rethrow_exception(writer_error);
+    }
+
+    // 인덱스는 8바이트 정렬 위치에 기록
+    while (offset % 8 != 0) {
+        file.put('\0');
+        ++offset;
+    }
+
+    GridSnapshotHeader header = {};
+    std::memcpy(header.magic, kGridSnapshotMagic, sizeof(header.magic));
+    header.version = kGridSnapshotVersion;
+    header.frame_count = static_cast<uint32_t>(index.size());
+    header.index_offset = offset;
+    header.grid_size = static_cast<uint32_t>(grid_size);
+    header.keyframe_interval = options.compress ? options.keyframe_interval : 1;
+    header.resolution = resolution;
+    header.velocity_scale = kGridSnapshotVelocityScale;
+
+    file.write(reinterpret_cast<const char*>(index.data()), index.size() * sizeof(GridSnapshotFrameEntry));
+    offset += index.size() * sizeof(GridSnapshotFrameEntry);
+    file.seekp(0);
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.close();
+    if (!file) {
+        throw std::runtime_error("Failed to finish grid snapshot");
+    }
+}
+
+GridSnapshotReader::GridSnapshotReader(const std::string& filename)
+    : mapped(new MappedFile(filename)) {
+    if (mapped->size() < sizeof(GridSnapshotHeader)) {
+        throw std::runtime_error("Grid snapshot too small: " + filename);
+    }
+
+    header = reinterpret_cast<const GridSnapshotHeader*>(mapped->data());
+    if (std::memcmp(header->magic, kGridSnapshotMagic, sizeof(kGridSnapshotMagic)) != 0) {
+        throw std::runtime_error("Not a DOGM grid snapshot: " + filename);
+    }
+    if (header->version != kGridSnapshotVersion) {
+        throw std::runtime_error("Unsupported grid snapshot version in " + filename);
+    }
+    if (header->grid_size == 0 ||
+        payloadSize(header->grid_size) > kMaxPayloadBytes / header->grid_size) {
+        throw std::runtime_error("Invalid grid size in grid snapshot: " + filename);
+    }
+    // 오프셋은 파일에서 온 값이므로 더하거나 곱하기 전에 범위를 확인한다 (wrap 방지).
+    // mmap 시작은 페이지 정렬이므로 오프셋 정렬이 곧 포인터 정렬이다.
+    const uint64_t index_offset = header->index_offset;
+    if (index_offset < sizeof(GridSnapshotHeader) || index_offset > mapped->size() ||
+        header->frame_count > (mapped->size() - index_offset) / sizeof(GridSnapshotFrameEntry)) {
+        throw std::runtime_error("Truncated grid snapshot: " + filename);
+    }
+    if (index_offset % alignof(GridSnapshotFrameEntry) != 0) {
+        throw std::runtime_error("Corrupt grid snapshot index: " + filename);
+    }
+
+    frame_count = header->frame_count;
+    index = reinterpret_cast<const GridSnapshotFrameEntry*>(mapped->data() + index_offset);
+    for (size_t i = 0; i < frame_count; ++i) {
+        const uint64_t data_offset = index[i].data_offset;
+        if (data_offset < sizeof(GridSnapshotHeader) || data_offset > index_offset ||
+            index[i].data_size > index_offset - data_offset) {
+            throw std::runtime_error("Corrupt grid snapshot index: " + filename);
+        }
+    }
+    if (frame_count > 0 && !(index[0].flags & kGridFrameKeyframe)) {
+        throw std::runtime_error("Grid snapshot does not start with a keyframe: " + filename);
+    }
+}
+
+void GridSnapshotReader::applyFrame(size_t frame_index) {
+    const GridSnapshotFrameEntry& entry = index[frame_index];
+    const size_t cells = static_cast<size_t>(header->grid_size) * header->grid_size;
+    const uint8_t* data = reinterpret_cast<const uint8_t*>(mapped->data() + entry.data_offset);
+
+    if (!(entry.flags & kGridFrameRle)) {
+        if (entry.data_size != payloadSize(cells)) {
+            throw std::runtime_error("Corrupt grid snapshot frame " + std::to_string(frame_index));
+        }
+        decoded.assign(data, data + entry.data_size);
+        return;
+    }
+    // keyframe이 아니면 decoded에 직전 프레임이 있어야 한다 (readFrame이 보장)
+    if (entry.flags & kGridFrameKeyframe) {
+        fillBaseline(decoded, cells);
+    } else {
+        const int dx = entry.origin_x - index[frame_index - 1].origin_x;
+        const int dy = entry.origin_y - index[frame_index - 1].origin_y;
+        if (dx != 0 || dy != 0) {
+            shiftPayload(decoded, dx, dy, static_cast<int>(header->grid_size), shifted);
+            std::swap(decoded, shifted);
+        }
+    }
+    if (!applyXorRle(data, data + entry.data_size, decoded)) {
+        throw std::runtime_error("Corrupt grid snapshot frame " + std::to_string(frame_index));
+    }
+}
+
+void GridSnapshotReader::readFrame(size_t frame_index, GridSnapshotFrame& frame) {
+    if (frame_index >= frame_count) {
+        throw std::out_of_range("Grid snapshot frame index out of range.");
+    }
+
+    if (frame_index != decoded_index) {
+        size_t keyframe = frame_index;
+        while (!(index[keyframe].flags & kGridFrameKeyframe)) --keyframe;
+        // 이미 복원한 프레임이 keyframe과 목표 사이에 있으면 거기서부터 이어간다
+        size_t start = keyframe;
+        if (decoded_index != SIZE_MAX && decoded_index >= keyframe && decoded_index < frame_index) {
+            start = decoded_index + 1;
+        }
+        decoded_index = SIZE_MAX;  // 도중에 실패하면 decoded는 무효
+        for (size_t i = start; i <= frame_index; ++i) {
+            applyFrame(i);
+        }
+        decoded_index = frame_index;
+    }
+
+    const size_t cells = static_cast<size_t>(header->grid_size) * header->grid_size;
+    const GridSnapshotFrameEntry& entry = index[frame_index];
+    frame.timestamp = entry.timestamp;
+    frame.origin_x = entry.origin_x;
+    frame.origin_y = entry.origin_y;
+    frame.resize(cells);
+    std::memcpy(frame.occupancy.data(), decoded.data(), cells);
+    std::memcpy(frame.velocity_x.data(), decoded.data() + cells, cells * sizeof(int16_t));
+    std::memcpy(frame.velocity_y.data(), decoded.data() + 3 * cells, cells * sizeof(int16_t));
+}
+
+bool GridSnapshotReader::isGridSnapshot(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    char magic[sizeof(kGridSnapshotMagic)] = {};
+    return file.read(magic, sizeof(magic)) && std::memcmp(magic, kGridSnapshotMagic, sizeof(magic)) == 0;
+}
+
+} // namespace dogm
@@ -0,0 +1,169 @@
+#pragma once
+
+#include "mapped_file.h"
+#include "spsc_ring.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <exception>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace dogm {
+
+// DOGM 그리드 스냅샷 (.dgrid)
+//
+//   [GridSnapshotHeader][frame payload ...][GridSnapshotFrameEntry x frame_count]
+//
+// 프레임마다 창 로컬 행 순서(y * grid_size + x)의 전체 그리드를 세 채널로 저장한다:
+//   occupancy[n]   uint8   pignistic 점유 확률 * 255 (반올림)
+//   velocity_x[n]  int16   평균 속도 [m/s] * velocity_scale (포화)
+//   velocity_y[n]  int16
+// 값은 little-endian이며 오프셋은 파일 시작 기준 바이트 단위이다.
+//
+// 압축 프레임(kGridFrameRle)은 기준 프레임과의 XOR 차이를 zero-run RLE로 저장한다. 토큰은
+// [varint 0 바이트 수][varint literal 바이트 수][literal]의 반복이다. keyframe의 기준은 빈 그리드
+// (점유 0.5, 속도 0), 그 외에는 창 원점 이동만큼 옮긴 직전 프레임이다 (새로 들어온 셀은 빈 그리드).
+// 특정 프레임은 앞의 가장 가까운 keyframe부터 복원한다.
+
+constexpr char kGridSnapshotMagic[8] = {'D', 'O', 'G', 'M', 'G', 'R', 'D', '\0'};
+constexpr uint32_t kGridSnapshotVersion = 1;
+constexpr float kGridSnapshotVelocityScale = 100.0f;  // 0.01 m/s 단위, ±327 m/s
+
+constexpr uint32_t kGridFrameKeyframe = 1u << 0;
+constexpr uint32_t kGridFrameRle = 1u << 1;
+
+struct GridSnapshotHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t frame_count;
+    uint64_t index_offset;
+    uint32_t grid_size;
+    uint32_t keyframe_interval;
+    float resolution;
+    float velocity_scale;
+};
+
+struct GridSnapshotFrameEntry {
+    double timestamp;
+    uint64_t data_offset;
+    uint32_t data_size;
+    uint32_t flags;
+    int32_t origin_x;  // 창 원점의 월드 셀 좌표 (follow_ego가 꺼져 있으면 0)
+    int32_t origin_y;
+};
+
+static_assert(sizeof(GridSnapshotHeader) == 40, "unexpected GridSnapshotHeader layout");
+static_assert(sizeof(GridSnapshotFrameEntry) == 32, "unexpected GridSnapshotFrameEntry layout");
+
+inline uint8_t quantizeOccupancy(float prob) {
+    return static_cast<uint8_t>(std::lround(std::min(std::max(prob, 0.0f), 1.0f) * 255.0f));
+}
+
+inline int16_t quantizeVelocity(float velocity, float scale = kGridSnapshotVelocityScale) {
+    const float q = std::min(std::max(velocity * scale, -32767.0f), 32767.0f);
+    return static_cast<int16_t>(std::lround(q));
+}
+
+// 디코딩된 프레임 (셀 인덱스 = y * grid_size + x)
+struct GridSnapshotFrame {
+    double timestamp = 0.0;
+    int32_t origin_x = 0;
+    int32_t origin_y = 0;
+    std::vector<uint8_t> occupancy;
+    std::vector<int16_t> velocity_x;
+    std::vector<int16_t> velocity_y;
+
+    void resize(size_t cell_count) {
+        occupancy.resize(cell_count);
+        velocity_x.resize(cell_count);
+        velocity_y.resize(cell_count);
+    }
+};
+
+struct GridSnapshotOptions {
+    bool compress = true;
+    uint32_t keyframe_interval = 30;  // 압축 시 이 프레임 수마다 keyframe (1이면 모든 프레임)
+    size_t queue_frames = 8;          // 인코딩/쓰기를 기다릴 수 있는 프레임 수
+};
+
+// 스냅샷 writer. 호출 스레드는 양자화된 프레임을 ring buffer 슬롯에 채우기만 하고,
+// 백그라운드 스레드가 인코딩과 파일 쓰기를 맡는다. 큐가 가득 차면 beginFrame이 기다린다.
+class GridSnapshotWriter {
+public:
+    GridSnapshotWriter(const std::string& filename, int grid_size, float resolution,
+                       const GridSnapshotOptions& options = GridSnapshotOptions());
+    ~GridSnapshotWriter();
+
+    GridSnapshotWriter(const GridSnapshotWriter&) = delete;
+    GridSnapshotWriter& operator=(const GridSnapshotWriter&) = delete;
+
+    // 다음 슬롯(채널 크기는 grid_size^2)을 돌려준다. 채운 뒤 commitFrame()을 호출한다.
+    GridSnapshotFrame& beginFrame();
+    void commitFrame();
+
+    // 큐에 남은 프레임을 쓰고 인덱스와 헤더를 기록한다. 쓰기 스레드의 오류는 여기서 다시 던진다.
+    // 소멸자에서도 호출된다 (이때 오류는 무시된다).
+    void close();
+
+    // close() 이후 파일 크기
+    uint64_t bytesWritten() const { return offset; }
+
+private:
+    void writerLoop();
+    void writeFrame(const GridSnapshotFrame& frame);
+
+    std::ofstream file;
+    int grid_size;
+    float resolution;
+    GridSnapshotOptions options;
+
+    SpscRing<GridSnapshotFrame> ring;
+    GridSnapshotFrame* pending = nullptr;
+    std::thread writer;
+    std::exception_ptr writer_error;
+    bool closed = false;
+
+    // 쓰기 스레드 전용
+    std::vector<GridSnapshotFrameEntry> index;
+    std::vector<uint8_t> current;    // raw payload
+    std::vector<uint8_t> reference;  // 직전 프레임 raw payload
+    std::vector<uint8_t> baseline;   // 빈 그리드 raw payload (keyframe 기준)
+    std::vector<uint8_t> shifted;    // 창이 이동한 프레임의 기준
+    std::vector<uint8_t> encoded;
+    uint64_t offset = 0;
+};
+
+// 파일을 mmap하여 프레임을 복원한다.
+class GridSnapshotReader {
+public:
+    explicit GridSnapshotReader(const std::string& filename);
+
+    size_t getTotalFrames() const { return frame_count; }
+    int getGridSize() const { return static_cast<int>(header->grid_size); }
+    float getResolution() const { return header->resolution; }
+    float getVelocityScale() const { return header->velocity_scale; }
+    double getTimestamp(size_t frame_index) const { return index[frame_index].timestamp; }
+
+    // 순서대로 읽으면 프레임당 한 번만 디코딩하고, 임의 접근이면 가장 가까운 keyframe부터 복원한다.
+    void readFrame(size_t frame_index, GridSnapshotFrame& frame);
+
+    static bool isGridSnapshot(const std::string& path);
+
+private:
+    void applyFrame(size_t frame_index);
+
+    std::unique_ptr<MappedFile> mapped;
+    const GridSnapshotHeader* header = nullptr;
+    const GridSnapshotFrameEntry* index = nullptr;
+    size_t frame_count = 0;
+
+    std::vector<uint8_t> decoded;   // 마지막으로 복원한 프레임의 raw payload
+    std::vector<uint8_t> shifted;
+    size_t decoded_index = SIZE_MAX;
+};
+
+} // namespace dogm
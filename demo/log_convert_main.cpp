@@ -0,0 +1,29 @@
+#include "data_loader.h"
+#include "sensor_log.h"
+#include <iostream>
+
+using namespace dogm;
+
+int main(int argc, char** argv) {
+    if (argc != 3) {
+        std::cerr << "Usage: " << argv[0] << " <input_data_directory> <output.dlog>" << std::endl;
+        return 1;
+    }
+
+    try {
+        RealDataLoader loader(argv[1]);
+        SensorLogWriter writer(argv[2]);
+
+        while (loader.hasNextFrame()) {
+            SensorFrame frame = loader.getNextFrame();
+            writer.writeFrame(SensorFrameView(frame));
+        }
+        writer.close();
+
+        std::cout << "Converted " << loader.getTotalFrames() << " frames to " << argv[2] << std::endl;
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
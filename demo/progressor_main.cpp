@@ -1,47 +1,86 @@
 #include "dogm/dogm.h"
-#include "data_loader.h"
+#include "grid_snapshot.h"
+#include "replay.h"
+#include "stats_writer.h"
 #include <iostream>
 #include <fstream>
 #include <chrono>
 #include <iomanip>
+#include <memory>
 
 using namespace dogm;
 
-float pignistic(const GridCell& cell) {
-    return cell.occ_mass + 0.5f * (1.0f - cell.occ_mass - cell.free_mass);
+bool endsWith(const std::string& text, const std::string& suffix) {
+    return text.size() >= suffix.size() && text.compare(text.size() - suffix.size(), suffix.size(), suffix) == 0;
 }
 
 int main(int argc, char** argv) {
-    if (argc != 3) {
-        std::cerr << "Usage: " << argv[0] << " <input_data_directory> <output_dogm.csv>" << std::endl;
+    if (argc < 3) {
+        std::cerr << "Usage: " << argv[0] << " <input_data_directory | input.dlog> <output_dogm.csv | output.dgrid>"
+                  << " [--stats <stats.csv | stats.json>] [--follow-ego] [--layout rowmajor|tiled|morton]"
+                  << " [--keyframe-interval <frames>] [--no-compression]" << std::endl;
         return 1;
     }
 
     std::string input_path = argv[1];
     std::string output_path = argv[2];
 
-    DOGM::Params params;
-    params.size = 20.0f;
-    params.resolution = 0.2f;
-    params.particle_count = 20000;
-    params.new_born_particle_count = 2000;
-    params.init_max_velocity = 3.0f;
+    std::unique_ptr<StatsWriter> stats_writer;
+    bool follow_ego = false;
+    GridLayout layout = GridLayout::RowMajor;
+    GridSnapshotOptions snapshot_options;
+    for (int i = 3; i < argc; ++i) {
+        std::string option = argv[i];
+        if (option == "--stats" && i + 1 < argc) {
+            stats_writer.reset(new StatsWriter(argv[++i]));
+        } else if (option == "--follow-ego") {
+            follow_ego = true;
+        } else if (option == "--layout" && i + 1 < argc) {
+            if (!parseGridLayout(argv[++i], layout)) {
+                std::cerr << "Error: Unknown grid layout " << argv[i] << std::endl;
+                return 1;
+            }
+        } else if (option == "--keyframe-interval" && i + 1 < argc) {
+            snapshot_options.keyframe_interval = static_cast<uint32_t>(std::max(1, std::atoi(argv[++i])));
+        } else if (option == "--no-compression") {
+            snapshot_options.compress = false;
+        } else {
+            std::cerr << "Error: Unknown option " << option << std::endl;
+            return 1;
+        }
+    }
+
+    DOGM::Params params = replayParams();
+    params.stats_histogram_window = 1000;
+    params.follow_ego = follow_ego;
+    params.grid_layout = layout;
     
     DOGM dogm(params);
-    RealDataLoader loader(input_path);
-    std::ofstream output_file(output_path);
 
-    if (!output_file.is_open()) {
-        std::cerr << "Error: Could not open output file " << output_path << std::endl;
-        return 1;
+    // .dgrid: 전체 그리드를 양자화해 바이너리 스냅샷으로 (인코딩과 쓰기는 백그라운드 스레드)
+    // 그 외: 불확실한 셀만 CSV로
+    std::unique_ptr<GridSnapshotWriter> snapshot_writer;
+    std::ofstream output_file;
+    if (endsWith(output_path, ".dgrid")) {
+        try {
+            snapshot_writer.reset(new GridSnapshotWriter(output_path, dogm.getGridSize(), params.resolution,
+                                                         snapshot_options));
+        } catch (const std::runtime_error& e) {
+            std::cerr << "Error: " << e.what() << std::endl;
+            return 1;
+        }
+    } else {
+        output_file.open(output_path);
+        if (!output_file.is_open()) {
+            std::cerr << "Error: Could not open output file " << output_path << std::endl;
+            return 1;
+        }
+        output_file << "timestamp,cell_x,cell_y,occ_prob,mean_vx,mean_vy\n";
     }
 
-    output_file << "timestamp,cell_x,cell_y,occ_prob,mean_vx,mean_vy\n";
-
     double last_timestamp = -1.0;
 
-    while(loader.hasNextFrame()) {
-        SensorFrame frame = loader.getNextFrame();
+    auto process_frame = [&](const SensorFrameView& frame, size_t frame_index, size_t total_frames) {
         float dt = (last_timestamp < 0) ? 0.1f : static_cast<float>(frame.timestamp - last_timestamp);
         last_timestamp = frame.timestamp;
 
@@ -50,27 +89,63 @@ int main(int argc, char** argv) {
         auto end = std::chrono::high_resolution_clock::now();
         auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(end - start);
         
-        std::cout << "Processing frame " << loader.getCurrentFrameIndex() << "/" << loader.getTotalFrames()
-                  << ", Update time: " << duration.count() << " ms" << std::endl;
+        std::cout << "Processing frame " << frame_index;
+        if (total_frames > 0) std::cout << "/" << total_frames; // 스트리밍 모드에서는 전체 프레임 수를 모름
+        std::cout << ", Update time: " << duration.count() << " ms" << std::endl;
+
+        if (stats_writer) {
+            stats_writer->write(frame.timestamp, dogm.getStats());
+        }
         
         const auto& grid_cells = dogm.getGridCells();
+        const auto& grid_moments = dogm.getGridMoments();
+        const GridWindow& window = dogm.getGridWindow();
         int grid_size = dogm.getGridSize();
 
+        // x, y는 창 기준 로컬 셀 좌표 (follow_ego가 꺼져 있으면 월드 셀 좌표와 같다).
+        // 저장 순서(grid_layout)와 무관하게 window.physicalIndex로 찾아 행 순서로 내보낸다.
+        if (snapshot_writer) {
+            captureGridSnapshot(dogm, frame.timestamp, snapshot_writer->beginFrame());
+            snapshot_writer->commitFrame();
+            return;
+        }
+
         for (int y = 0; y < grid_size; ++y) {
             for (int x = 0; x < grid_size; ++x) {
-                const auto& cell = grid_cells[y * grid_size + x];
+                const int idx = window.physicalIndex(x, y);
+                const auto& cell = grid_cells[idx];
                 float prob = pignistic(cell);
                 if (prob > 0.15f && prob < 0.85f) {
                      output_file << std::fixed << std::setprecision(4) << frame.timestamp << ","
                                  << x << "," << y << "," << prob << ","
-                                 << cell.mean_x_vel << "," << cell.mean_y_vel << "\n";
+                                 << grid_moments[idx].mean_x_vel << "," << grid_moments[idx].mean_y_vel << "\n";
                 }
             }
         }
+    };
+
+    // 바이너리 로그는 mmap된 파일에서 복사 없이, TXT 로그는 백그라운드 스레드가 파싱하는 동안
+    // DOGM 업데이트를 수행 (메모리 사용량 일정)
+    try {
+        replaySensorLog(input_path, process_frame);
+    } catch (const std::runtime_error& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+
+    if (snapshot_writer) {
+        try {
+            snapshot_writer->close();
+        } catch (const std::runtime_error& e) {
+            std::cerr << "Error: " << e.what() << std::endl;
+            return 1;
+        }
+    } else {
+        output_file.close();
     }
 
+    printLatencySummary(std::cout, dogm.getLatencyHistogram());
     std::cout << "Processing finished. Output saved to " << output_path << std::endl;
-    output_file.close();
 
     return 0;
 }
\ No newline at end of file
@@ -0,0 +1,208 @@
+// 결정적 재생 회귀 검사.
+// 로그를 처음부터 재생해 프레임마다 양자화된 점유/속도 그리드를 golden 스냅샷(.dgrid)과 비교하고,
+// 프레임별 updateGrid 시간을 함께 보고한다. 커널 결과는 스레드 수와 SIMD 수준에 무관하므로
+// (counter-based RNG, 안정 정렬, 고정 순서 합산) 허용 오차 0으로도 비교할 수 있다.
+//
+// 사용법: dogm_regress <input_data_directory | input.dlog> <golden.dgrid> [--record]
+//                      [--occ-tol <1/255 단위>] [--vel-tol <m/s>] [--follow-ego] [--layout rowmajor|tiled|morton]
+//                      [--staged] [--dense] [--compact]
+//   --record: 비교 대신 golden 스냅샷을 기록한다
+//   --staged, --dense: 단계별 셀 갱신 / 전체 셀 처리로 실행한다 (fused, sparse 경로와 결과가 같아야 한다)
+//   --compact: compact_particle_state로 실행한다. 양자화 때문에 float golden과 bit 단위로 같지 않으므로
+//              허용 오차와 함께 정확도 비교에 쓴다.
+// grid layout과 follow_ego는 파티클 순서와 창을 바꾸므로 golden과 같은 값으로 실행해야 한다.
+#include "dogm/dogm.h"
+#include "grid_snapshot.h"
+#include "replay.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <vector>
+
+using namespace dogm;
+
+namespace {
+
+struct FrameDiff {
+    int max_occupancy = 0;       // 1/255 단위
+    float max_velocity = 0.0f;   // m/s
+    int cells_over_tolerance = 0;
+    bool origin_mismatch = false;
+};
+
+FrameDiff compareFrames(const GridSnapshotFrame& golden, const GridSnapshotFrame& actual, int occ_tolerance,
+                        float vel_tolerance, float velocity_scale) {
+    FrameDiff diff;
+    diff.origin_mismatch = golden.origin_x != actual.origin_x || golden.origin_y != actual.origin_y;
+    int max_velocity_steps = 0;
+    for (size_t i = 0; i < golden.occupancy.size(); ++i) {
+        const int d_occ = std::abs(golden.occupancy[i] - actual.occupancy[i]);
+        const int d_vel = std::max(std::abs(golden.velocity_x[i] - actual.velocity_x[i]),
+                                   std::abs(golden.velocity_y[i] - actual.velocity_y[i]));
+        diff.max_occupancy = std::max(diff.max_occupancy, d_occ);
+        max_velocity_steps = std::max(max_velocity_steps, d_vel);
+        diff.cells_over_tolerance += d_occ > occ_tolerance || d_vel / velocity_scale > vel_tolerance;
+    }
+    diff.max_velocity = max_velocity_steps / velocity_scale;
+    return diff;
+}
+
+double percentile(std::vector<double> values, double p) {
+    if (values.empty()) return 0.0;
+    const size_t k = std::min(values.size() - 1, static_cast<size_t>(p * values.size()));
+    std::nth_element(values.begin(), values.begin() + k, values.end());
+    return values[k];
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    if (argc < 3) {
+        std::cerr << "Usage: " << argv[0] << " <input_data_directory | input.dlog> <golden.dgrid> [--record]"
+                  << " [--occ-tol <1/255 steps>] [--vel-tol <m/s>] [--follow-ego]"
+                  << " [--layout rowmajor|tiled|morton] [--staged] [--dense] [--compact]" << std::endl;
+        return 1;
+    }
+
+    std::string input_path = argv[1];
+    std::string golden_path = argv[2];
+
+    bool record = false;
+    int occ_tolerance = 0;
+    float vel_tolerance = 0.0f;
+    bool follow_ego = false;
+    bool staged = false, dense = false, compact = false;
+    GridLayout layout = GridLayout::RowMajor;
+    for (int i = 3; i < argc; ++i) {
+        std::string option = argv[i];
+        if (option == "--record") {
+            record = true;
+        } else if (option == "--occ-tol" && i + 1 < argc) {
+            occ_tolerance = std::max(0, std::atoi(argv[++i]));
+        } else if (option == "--vel-tol" && i + 1 < argc) {
+            vel_tolerance = std::max(0.0f, static_cast<float>(std::atof(argv[++i])));
+        } else if (option == "--follow-ego") {
+            follow_ego = true;
+        } else if (option == "--staged") {
+            staged = true;
+        } else if (option == "--dense") {
+            dense = true;
+        } else if (option == "--compact") {
+            compact = true;
+        } else if (option == "--layout" && i + 1 < argc) {
+            if (!parseGridLayout(argv[++i], layout)) {
+                std::cerr << "Error: Unknown grid layout " << argv[i] << std::endl;
+                return 1;
+            }
+        } else {
+            std::cerr << "Error: Unknown option " << option << std::endl;
+            return 1;
+        }
+    }
+
+    DOGM::Params params = replayParams();
+    params.follow_ego = follow_ego;
+    params.grid_layout = layout;
+    params.fused_cell_update = !staged;
+    params.sparse_cells = !dense;
+    params.compact_particle_state = compact;
+    DOGM dogm(params);
+
+    std::unique_ptr<GridSnapshotWriter> writer;
+    std::unique_ptr<GridSnapshotReader> reader;
+    try {
+        if (record) {
+            writer.reset(new GridSnapshotWriter(golden_path, dogm.getGridSize(), params.resolution));
+        } else {
+            reader.reset(new GridSnapshotReader(golden_path));
+        }
+    } catch (const std::runtime_error& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+    if (reader && (reader->getGridSize() != dogm.getGridSize() || reader->getResolution() != params.resolution)) {
+        std::cerr << "Error: golden grid " << reader->getGridSize() << " cells at " << reader->getResolution()
+                  << " m does not match replay grid " << dogm.getGridSize() << " cells at " << params.resolution
+                  << " m" << std::endl;
+        return 1;
+    }
+
+    GridSnapshotFrame actual, golden;
+    std::vector<double> update_ms;
+    size_t frame_count = 0, failed_frames = 0;
+    FrameDiff worst;
+    double last_timestamp = -1.0;
+
+    auto replay_frame = [&](const SensorFrameView& frame, size_t frame_index, size_t) {
+        float dt = (last_timestamp < 0) ? 0.1f : static_cast<float>(frame.timestamp - last_timestamp);
+        last_timestamp = frame.timestamp;
+
+        auto start = std::chrono::steady_clock::now();
+        dogm.updateGrid(frame, dt);
+        update_ms.push_back(std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+        ++frame_count;
+
+        if (writer) {
+            captureGridSnapshot(dogm, frame.timestamp, writer->beginFrame());
+            writer->commitFrame();
+            return;
+        }
+        if (frame_index > reader->getTotalFrames()) return;  // 프레임 수 차이는 끝에서 보고
+
+        captureGridSnapshot(dogm, frame.timestamp, actual);
+        reader->readFrame(frame_index - 1, golden);
+        const FrameDiff diff = compareFrames(golden, actual, occ_tolerance, vel_tolerance,
+                                             reader->getVelocityScale());
+        worst.max_occupancy = std::max(worst.max_occupancy, diff.max_occupancy);
+        worst.max_velocity = std::max(worst.max_velocity, diff.max_velocity);
+        worst.cells_over_tolerance += diff.cells_over_tolerance;
+        if (diff.cells_over_tolerance > 0 || diff.origin_mismatch) {
+            // 처음 몇 프레임만 자세히 출력한다
+            if (failed_frames < 10) {
+                std::cout << "frame " << frame_index << " (t = " << std::fixed << std::setprecision(3)
+                          << frame.timestamp << "): " << diff.cells_over_tolerance << " cells over tolerance, max d_occ "
+                          << diff.max_occupancy << "/255, max d_vel " << std::setprecision(2) << diff.max_velocity
+                          << " m/s" << (diff.origin_mismatch ? ", window origin differs" : "") << std::endl;
+            }
+            ++failed_frames;
+        }
+    };
+
+    try {
+        replaySensorLog(input_path, replay_frame);
+        if (writer) writer->close();
+    } catch (const std::runtime_error& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+
+    double total_ms = 0.0;
+    for (double ms : update_ms) total_ms += ms;
+    std::cout << std::fixed << std::setprecision(3) << "updateGrid: " << frame_count << " frames, mean "
+              << (frame_count ? total_ms / frame_count : 0.0) << " ms, p50 " << percentile(update_ms, 0.5)
+              << " ms, p95 " << percentile(update_ms, 0.95) << " ms, max "
+              << (update_ms.empty() ? 0.0 : *std::max_element(update_ms.begin(), update_ms.end())) << " ms"
+              << std::endl;
+
+    if (writer) {
+        std::cout << "Recorded " << frame_count << " golden frames to " << golden_path << std::endl;
+        return 0;
+    }
+
+    const bool count_ok = frame_count == reader->getTotalFrames();
+    if (!count_ok) {
+        std::cout << "frame count differs: replay " << frame_count << ", golden " << reader->getTotalFrames()
+                  << std::endl;
+    }
+    std::cout << "max d_occ " << worst.max_occupancy << "/255 (tol " << occ_tolerance << "), max d_vel "
+              << std::setprecision(2) << worst.max_velocity << " m/s (tol " << vel_tolerance << "), "
+              << failed_frames << " of " << frame_count << " frames over tolerance" << std::endl;
+
+    const bool ok = count_ok && failed_frames == 0;
+    std::cout << (ok ? "PASS" : "FAIL") << std::endl;
+    return ok ? 0 : 1;
+}
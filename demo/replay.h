@@ -0,0 +1,69 @@
+#pragma once
+
+#include "dogm/dogm.h"
+#include "frame_stream.h"
+#include "grid_snapshot.h"
+#include "sensor_log.h"
+#include <string>
+
+namespace dogm {
+
+// dogm_processor와 dogm_regress가 공유하는 설정. golden 스냅샷은 이 값으로 기록되므로
+// 바꾸면 golden도 다시 기록해야 한다.
+inline DOGM::Params replayParams() {
+    DOGM::Params params;
+    params.size = 20.0f;
+    params.resolution = 0.2f;
+    params.particle_count = 20000;
+    params.new_born_particle_count = 2000;
+    params.init_max_velocity = 3.0f;
+    return params;
+}
+
+inline float pignistic(const GridCell& cell) {
+    return cell.occ_mass + 0.5f * (1.0f - cell.occ_mass - cell.free_mass);
+}
+
+// 현재 그리드를 창 로컬 행 순서로 양자화한다 (.dgrid 프레임과 같은 형식).
+// 저장 순서(grid_layout)와 무관하게 window.physicalIndex로 찾는다.
+inline void captureGridSnapshot(const DOGM& dogm, double timestamp, GridSnapshotFrame& snapshot) {
+    const auto& grid_cells = dogm.getGridCells();
+    const auto& grid_moments = dogm.getGridMoments();
+    const GridWindow& window = dogm.getGridWindow();
+    const int grid_size = dogm.getGridSize();
+
+    snapshot.resize(static_cast<size_t>(grid_size) * grid_size);
+    snapshot.timestamp = timestamp;
+    snapshot.origin_x = window.origin_x;
+    snapshot.origin_y = window.origin_y;
+    for (int y = 0; y < grid_size; ++y) {
+        for (int x = 0; x < grid_size; ++x) {
+            const int idx = window.physicalIndex(x, y);
+            const int out = y * grid_size + x;
+            snapshot.occupancy[out] = quantizeOccupancy(pignistic(grid_cells[idx]));
+            snapshot.velocity_x[out] = quantizeVelocity(grid_moments[idx].mean_x_vel);
+            snapshot.velocity_y[out] = quantizeVelocity(grid_moments[idx].mean_y_vel);
+        }
+    }
+}
+
+// 로그의 프레임을 순서대로 fn(frame, frame_index, total_frames)에 넘긴다 (frame_index는 1부터).
+// .dlog는 mmap된 파일에서 복사 없이, TXT 디렉토리는 백그라운드 파싱 스트림으로 읽는다
+// (이때 전체 프레임 수를 모르므로 total_frames는 0).
+template<typename Fn>
+void replaySensorLog(const std::string& input_path, Fn&& fn) {
+    if (SensorLogReader::isSensorLog(input_path)) {
+        SensorLogReader reader(input_path);
+        for (size_t i = 0; i < reader.getTotalFrames(); ++i) {
+            fn(reader.getFrame(i), i + 1, reader.getTotalFrames());
+        }
+    } else {
+        StreamingDataLoader loader(input_path);
+        while (const SensorFrame* frame = loader.acquireFrame()) {
+            fn(SensorFrameView(*frame), loader.getCurrentFrameIndex() + 1, size_t(0));
+            loader.releaseFrame();
+        }
+    }
+}
+
+} // namespace dogm
@@ -0,0 +1,152 @@
+#include "sensor_log.h"
+#include <cstring>
+#include <stdexcept>
+
+namespace dogm {
+
+SensorLogWriter::SensorLogWriter(const std::string& filename)
+    : file(filename, std::ios::binary | std::ios::trunc) {
+    if (!file.is_open()) {
+        throw std::runtime_error("Cannot open sensor log for writing: " + filename);
+    }
+    // 헤더 자리는 close()에서 채운다.
+    SensorLogHeader header = {};
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    offset = sizeof(header);
+}
+
+SensorLogWriter::~SensorLogWriter() {
+    if (file.is_open()) {
+        try {
+            close();
+        } catch (...) {
+        }
+    }
+}
+
+void SensorLogWriter::writeColumn(const float* values, size_t count, size_t stride) {
+    if (stride == 1) {
+        file.write(reinterpret_cast<const char*>(values), count * sizeof(float));
+    } else {
+        for (size_t i = 0; i < count; ++i) {
+            file.write(reinterpret_cast<const char*>(&values[i * stride]), sizeof(float));
+        }
+    }
+    offset += count * sizeof(float);
+}
+
+void SensorLogWriter::writeFrame(const SensorFrameView& frame) {
+    SensorLogFrameEntry entry = {};
+    entry.timestamp = frame.timestamp;
+    entry.ego_x = frame.ego_pose.x();
+    entry.ego_y = frame.ego_pose.y();
+    entry.ego_yaw = frame.ego_yaw;
+    entry.lidar_count = static_cast<uint32_t>(frame.lidar_count);
+    entry.radar_count = static_cast<uint32_t>(frame.radar_count);
+    entry.data_offset = offset;
+    index.push_back(entry);
+
+    writeColumn(frame.lidar_ranges, frame.lidar_count, 1);
+    writeColumn(frame.lidar_angles, frame.lidar_count, 1);
+    writeColumn(frame.radar_x, frame.radar_count, frame.radar_stride);
+    writeColumn(frame.radar_y, frame.radar_count, frame.radar_stride);
+    writeColumn(frame.radar_velocity, frame.radar_count, frame.radar_stride);
+    writeColumn(frame.radar_snr, frame.radar_count, frame.radar_stride);
+    if (!file) {
+        throw std::runtime_error("Failed to write sensor log frame");
+    }
+}
+
+void SensorLogWriter::close() {
+    // 인덱스는 8바이트 정렬 위치에 기록
+    while (offset % 8 != 0) {
+        file.put('\0');
+        ++offset;
+    }
+
+    SensorLogHeader header = {};
+    std::memcpy(header.magic, kSensorLogMagic, sizeof(header.magic));
+    header.version = kSensorLogVersion;
+    header.frame_count = static_cast<uint32_t>(index.size());
+    header.index_offset = offset;
+
+    file.write(reinterpret_cast<const char*>(index.data()), index.size() * sizeof(SensorLogFrameEntry));
+    file.seekp(0);
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.close();
+    if (!file) {
+        throw std::runtime_error("Failed to finish sensor log");
+    }
+}
+
+SensorLogReader::SensorLogReader(const std::string& filename)
+    : mapped(new MappedFile(filename)) {
+    if (mapped->size() < sizeof(SensorLogHeader)) {
+        throw std::runtime_error("Sensor log too small: " + filename);
+    }
+
+    const auto* header = reinterpret_cast<const SensorLogHeader*>(mapped->data());
+    if (std::memcmp(header->magic, kSensorLogMagic, sizeof(kSensorLogMagic)) != 0) {
+        throw std::runtime_error("Not a DOGM sensor log: " + filename);
+    }
+    if (header->version != kSensorLogVersion) {
+        throw std::runtime_error("Unsupported sensor log version in " + filename);
+    }
+    // 오프셋은 파일에서 온 값이므로 더하거나 곱하기 전에 범위를 확인한다 (wrap 방지).
+    // mmap 시작은 페이지 정렬이므로 오프셋 정렬이 곧 포인터 정렬이다.
+    const uint64_t index_offset = header->index_offset;
+    if (index_offset < sizeof(SensorLogHeader) || index_offset > mapped->size() ||
+        header->frame_count > (mapped->size() - index_offset) / sizeof(SensorLogFrameEntry)) {
+        throw std::runtime_error("Truncated sensor log: " + filename);
+    }
+    if (index_offset % alignof(SensorLogFrameEntry) != 0) {
+        throw std::runtime_error("Corrupt sensor log index: " + filename);
+    }
+
+    frame_count = header->frame_count;
+    index = reinterpret_cast<const SensorLogFrameEntry*>(mapped->data() + index_offset);
+    for (size_t i = 0; i < frame_count; ++i) {
+        // 프레임 데이터: lidar range/angle 두 열, radar x/y/velocity/snr 네 열 (uint32 개수라 wrap하지 않는다)
+        const uint64_t data_offset = index[i].data_offset;
+        const uint64_t data_size =
+            (2 * static_cast<uint64_t>(index[i].lidar_count) + 4 * static_cast<uint64_t>(index[i].radar_count)) *
+            sizeof(float);
+        if (data_offset < sizeof(SensorLogHeader) || data_offset > index_offset ||
+            data_size > index_offset - data_offset || data_offset % alignof(float) != 0) {
+            throw std::runtime_error("Corrupt sensor log index: " + filename);
+        }
+    }
+}
+
+SensorFrameView SensorLogReader::getFrame(size_t frame_index) const {
+    if (frame_index >= frame_count) {
+        throw std::out_of_range("Sensor log frame index out of range.");
+    }
+    const SensorLogFrameEntry& entry = index[frame_index];
+    const float* data = reinterpret_cast<const float*>(mapped->data() + entry.data_offset);
+    const size_t n = entry.lidar_count;
+    const size_t m = entry.radar_count;
+
+    SensorFrameView view;
+    view.timestamp = entry.timestamp;
+    view.lidar_count = n;
+    view.lidar_ranges = data;
+    view.lidar_angles = data + n;
+    view.radar_count = m;
+    view.radar_stride = 1;
+    view.radar_x = data + 2 * n;
+    view.radar_y = data + 2 * n + m;
+    view.radar_velocity = data + 2 * n + 2 * m;
+    view.radar_snr = data + 2 * n + 3 * m;
+    view.ego_pose = Vec2(entry.ego_x, entry.ego_y);
+    view.ego_yaw = entry.ego_yaw;
+    return view;
+}
+
+bool SensorLogReader::isSensorLog(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    char magic[sizeof(kSensorLogMagic)] = {};
+    return file.read(magic, sizeof(magic)) && std::memcmp(magic, kSensorLogMagic, sizeof(magic)) == 0;
+}
+
+} // namespace dogm
@@ -0,0 +1,83 @@
+#pragma once
+
+#include "dogm/dogm_types.h"
+#include "mapped_file.h"
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace dogm {
+
+// DOGM 바이너리 센서 로그 (.dlog)
+//
+//   [SensorLogHeader][frame data ...][SensorLogFrameEntry x frame_count]
+//
+// 각 프레임 데이터는 열 단위 float 배열로 저장된다:
+//   lidar_ranges[n] lidar_angles[n] radar_x[m] radar_y[m] radar_velocity[m] radar_snr[m]
+// 값은 little-endian이며 오프셋은 파일 시작 기준 바이트 단위이다.
+// 프레임 인덱스는 파일 끝에 있어 변환 시 프레임을 순차적으로 append할 수 있다.
+
+constexpr char kSensorLogMagic[8] = {'D', 'O', 'G', 'M', 'L', 'O', 'G', '\0'};
+constexpr uint32_t kSensorLogVersion = 1;
+
+struct SensorLogHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t frame_count;
+    uint64_t index_offset;
+    uint64_t reserved;
+};
+
+struct SensorLogFrameEntry {
+    double timestamp;
+    float ego_x;
+    float ego_y;
+    float ego_yaw;
+    uint32_t lidar_count;
+    uint32_t radar_count;
+    uint32_t reserved;
+    uint64_t data_offset;
+};
+
+static_assert(sizeof(SensorLogHeader) == 32, "unexpected SensorLogHeader layout");
+static_assert(sizeof(SensorLogFrameEntry) == 40, "unexpected SensorLogFrameEntry layout");
+
+class SensorLogWriter {
+public:
+    explicit SensorLogWriter(const std::string& filename);
+    ~SensorLogWriter();
+
+    void writeFrame(const SensorFrameView& frame);
+    // 프레임 인덱스와 헤더를 기록한다. 소멸자에서도 호출된다.
+    void close();
+
+private:
+    void writeColumn(const float* values, size_t count, size_t stride);
+
+    std::ofstream file;
+    std::vector<SensorLogFrameEntry> index;
+    uint64_t offset = 0;
+};
+
+// 파일을 mmap하여 파싱이나 복사 없이 프레임 뷰를 제공한다.
+class SensorLogReader {
+public:
+    explicit SensorLogReader(const std::string& filename);
+
+    size_t getTotalFrames() const { return frame_count; }
+    double getTimestamp(size_t frame_index) const { return index[frame_index].timestamp; }
+
+    // 반환된 뷰는 reader가 살아 있는 동안 유효하다.
+    SensorFrameView getFrame(size_t frame_index) const;
+
+    static bool isSensorLog(const std::string& path);
+
+private:
+    std::unique_ptr<MappedFile> mapped;
+    const SensorLogFrameEntry* index = nullptr;
+    size_t frame_count = 0;
+};
+
+} // namespace dogm
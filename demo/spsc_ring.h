@@ -0,0 +1,95 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+#include <vector>
+
+namespace dogm {
+
+// Bounded lock-free single-producer/single-consumer ring buffer.
+// 슬롯은 제자리에서 재사용되므로 T가 vector를 가지면 용량이 유지되어 재할당이 없다.
+// waitWrite/waitRead는 가득 찬/빈 경우 condition_variable로 잠든다. commit은 상대를 깨우기 위해
+// mutex를 잠깐 잡는다 (프레임 단위 사용에서는 무시할 만한 비용).
+template<typename T>
+class SpscRing {
+public:
+    explicit SpscRing(size_t capacity) {
+        size_t size = 1;
+        while (size < capacity) size <<= 1;
+        slots.resize(size);
+        mask = size - 1;
+    }
+
+    // Producer: 쓸 슬롯을 얻는다. 가득 찼으면 nullptr.
+    T* beginWrite() {
+        size_t head = write_pos.load(std::memory_order_relaxed);
+        if (head - read_pos.load(std::memory_order_acquire) == slots.size()) return nullptr;
+        return &slots[head & mask];
+    }
+
+    void commitWrite() {
+        write_pos.store(write_pos.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+        notify();
+    }
+
+    // beginWrite와 같지만 빈 슬롯이 생길 때까지 기다린다. 가득 찬 채로 close()되면 nullptr.
+    T* waitWrite() {
+        if (T* slot = beginWrite()) return slot;
+        T* slot = nullptr;
+        std::unique_lock<std::mutex> lock(wait_mutex);
+        wait_cv.wait(lock, [&] { return (slot = beginWrite()) != nullptr || closed; });
+        return slot;
+    }
+
+    // Consumer: 읽을 슬롯을 얻는다. 비었으면 nullptr.
+    T* beginRead() {
+        size_t tail = read_pos.load(std::memory_order_relaxed);
+        if (tail == write_pos.load(std::memory_order_acquire)) return nullptr;
+        return &slots[tail & mask];
+    }
+
+    void commitRead() {
+        read_pos.store(read_pos.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+        notify();
+    }
+
+    // beginRead와 같지만 프레임이 들어올 때까지 기다린다. 빈 채로 close()되면 nullptr
+    // (close() 전에 커밋된 슬롯은 모두 읽을 수 있다).
+    T* waitRead() {
+        if (T* slot = beginRead()) return slot;
+        T* slot = nullptr;
+        std::unique_lock<std::mutex> lock(wait_mutex);
+        wait_cv.wait(lock, [&] { return (slot = beginRead()) != nullptr || closed; });
+        return slot;
+    }
+
+    // 더 이상 쓰거나 읽지 않음을 알리고 대기 중인 쪽을 깨운다 (producer 종료, consumer 중단 모두)
+    void close() {
+        {
+            std::lock_guard<std::mutex> lock(wait_mutex);
+            closed = true;
+        }
+        wait_cv.notify_all();
+    }
+
+    size_t capacity() const { return slots.size(); }
+
+private:
+    // 상대가 잠들기 직전(조건 확인 뒤, wait 전)이면 mutex를 잡는 동안 기다리게 되어 깨움을 놓치지 않는다
+    void notify() {
+        { std::lock_guard<std::mutex> lock(wait_mutex); }
+        wait_cv.notify_one();
+    }
+
+    std::vector<T> slots;
+    size_t mask = 0;
+    alignas(64) std::atomic<size_t> write_pos{0};
+    alignas(64) std::atomic<size_t> read_pos{0};
+    std::mutex wait_mutex;
+    std::condition_variable wait_cv;
+    bool closed = false;  // wait_mutex로 보호
+};
+
+} // namespace dogm
@@ -0,0 +1,72 @@
+#include "stats_writer.h"
+#include <iomanip>
+#include <stdexcept>
+
+namespace dogm {
+
+namespace {
+
+bool endsWith(const std::string& text, const std::string& suffix) {
+    return text.size() >= suffix.size() && text.compare(text.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+} // namespace
+
+StatsWriter::StatsWriter(const std::string& filename)
+    : file(filename), json(endsWith(filename, ".json") || endsWith(filename, ".jsonl")) {
+    if (!file.is_open()) {
+        throw std::runtime_error("Cannot open stats file: " + filename);
+    }
+    file << std::fixed << std::setprecision(4);
+
+    if (!json) {
+        file << "frame,timestamp,total_ms";
+        for (int i = 0; i < kStageCount; ++i) {
+            file << "," << stageName(static_cast<Stage>(i)) << "_ms";
+        }
+        file << ",particles_alive,particles_out_of_bounds,particles_born,effective_sample_size"
+             << ",meas_occupied_cells,meas_free_cells,meas_radar_cells\n";
+    }
+}
+
+void StatsWriter::write(double timestamp, const DOGMStats& stats) {
+    if (json) {
+        file << "{\"frame\":" << stats.frame << ",\"timestamp\":" << timestamp
+             << ",\"total_ms\":" << stats.total_ms << ",\"stage_ms\":{";
+        for (int i = 0; i < kStageCount; ++i) {
+            file << (i ? "," : "") << "\"" << stageName(static_cast<Stage>(i)) << "\":" << stats.stage_ms[i];
+        }
+        file << "},\"particles_alive\":" << stats.particles_alive
+             << ",\"particles_out_of_bounds\":" << stats.particles_out_of_bounds
+             << ",\"particles_born\":" << stats.particles_born
+             << ",\"effective_sample_size\":" << stats.effective_sample_size
+             << ",\"meas_occupied_cells\":" << stats.meas_occupied_cells
+             << ",\"meas_free_cells\":" << stats.meas_free_cells
+             << ",\"meas_radar_cells\":" << stats.meas_radar_cells << "}\n";
+    } else {
+        file << stats.frame << "," << timestamp << "," << stats.total_ms;
+        for (int i = 0; i < kStageCount; ++i) {
+            file << "," << stats.stage_ms[i];
+        }
+        file << "," << stats.particles_alive << "," << stats.particles_out_of_bounds
+             << "," << stats.particles_born << "," << stats.effective_sample_size
+             << "," << stats.meas_occupied_cells << "," << stats.meas_free_cells
+             << "," << stats.meas_radar_cells << "\n";
+    }
+}
+
+void printLatencySummary(std::ostream& out, const LatencyHistogram& histogram) {
+    if (histogram.total.count() == 0) return;
+
+    out << "Latency over last " << histogram.total.count() << " frames (p50 / p99 ms):" << std::endl;
+    out << std::fixed << std::setprecision(3);
+    for (int i = 0; i < kStageCount; ++i) {
+        out << "  " << std::left << std::setw(22) << stageName(static_cast<Stage>(i)) << std::right
+            << std::setw(10) << histogram.stages[i].percentile(50) << " / "
+            << histogram.stages[i].percentile(99) << std::endl;
+    }
+    out << "  " << std::left << std::setw(22) << "total" << std::right
+        << std::setw(10) << histogram.total.percentile(50) << " / " << histogram.total.percentile(99) << std::endl;
+}
+
+} // namespace dogm
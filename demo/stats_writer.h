@@ -0,0 +1,25 @@
+#pragma once
+
+#include "dogm/stats.h"
+#include <fstream>
+#include <string>
+
+namespace dogm {
+
+// 프레임별 DOGMStats를 파일로 기록한다.
+// 확장자가 .json/.jsonl이면 한 줄에 JSON 객체 하나(JSON Lines), 그 외에는 CSV.
+class StatsWriter {
+public:
+    explicit StatsWriter(const std::string& filename);
+
+    void write(double timestamp, const DOGMStats& stats);
+
+private:
+    std::ofstream file;
+    bool json = false;
+};
+
+// p50/p99 latency 요약을 출력한다.
+void printLatencySummary(std::ostream& out, const LatencyHistogram& histogram);
+
+} // namespace dogm
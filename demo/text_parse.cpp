@@ -0,0 +1,30 @@
+#include "text_parse.h"
+
+namespace dogm {
+
+std::vector<TextChunk> splitIntoChunks(const char* begin, const char* end, size_t chunk_count) {
+    std::vector<TextChunk> chunks;
+    if (chunk_count == 0) chunk_count = 1;
+    const size_t total = static_cast<size_t>(end - begin);
+    const char* chunk_begin = begin;
+
+    for (size_t i = 1; i <= chunk_count && chunk_begin < end; ++i) {
+        const char* chunk_end = (i == chunk_count) ? end : begin + total * i / chunk_count;
+        if (chunk_end < chunk_begin) chunk_end = chunk_begin;
+        // 줄 중간에서 끊기지 않도록 다음 개행 뒤로 이동
+        if (chunk_end < end) {
+            const char* newline = static_cast<const char*>(std::memchr(chunk_end, '\n', end - chunk_end));
+            chunk_end = newline ? newline + 1 : end;
+        }
+        chunks.push_back({chunk_begin, chunk_end});
+        chunk_begin = chunk_end;
+    }
+    return chunks;
+}
+
+const char* skipLine(const char* begin, const char* end) {
+    const char* newline = static_cast<const char*>(std::memchr(begin, '\n', end - begin));
+    return newline ? newline + 1 : end;
+}
+
+} // namespace dogm
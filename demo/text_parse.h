@@ -0,0 +1,70 @@
+#pragma once
+
+#include <charconv>
+#include <cstddef>
+#include <cstring>
+#include <vector>
+
+namespace dogm {
+
+// Zero-allocation 텍스트 파서. 버퍼(보통 MappedFile)를 직접 훑으며 std::from_chars로 숫자를 읽는다.
+// 로케일 조회나 문자열 복사가 없다.
+
+struct TextChunk {
+    const char* begin;
+    const char* end;
+};
+
+// 줄 단위 순회. 개행 검색은 memchr(libc의 SIMD 구현)를 사용한다.
+class LineCursor {
+public:
+    LineCursor(const char* begin, const char* end) : pos(begin), end(end) {}
+    explicit LineCursor(const TextChunk& chunk) : pos(chunk.begin), end(chunk.end) {}
+
+    bool nextLine(const char*& line_begin, const char*& line_end) {
+        if (pos >= end) return false;
+        line_begin = pos;
+        const char* newline = static_cast<const char*>(std::memchr(pos, '\n', end - pos));
+        line_end = newline ? newline : end;
+        pos = newline ? newline + 1 : end;
+        return true;
+    }
+
+private:
+    const char* pos;
+    const char* end;
+};
+
+// 한 줄 안의 필드를 순서대로 읽는다. 공백과 delimiter를 구분자로 취급한다.
+class FieldParser {
+public:
+    FieldParser(const char* begin, const char* end, char delimiter = ' ')
+        : pos(begin), end(end), delimiter(delimiter) {}
+
+    template<typename T>
+    bool next(T& value) {
+        skipSeparators();
+        if (pos >= end) return false;
+        auto result = std::from_chars(pos, end, value);
+        if (result.ec != std::errc()) return false;
+        pos = result.ptr;
+        return true;
+    }
+
+private:
+    void skipSeparators() {
+        while (pos < end && (*pos == ' ' || *pos == '\t' || *pos == '\r' || *pos == delimiter)) ++pos;
+    }
+
+    const char* pos;
+    const char* end;
+    char delimiter;
+};
+
+// 버퍼를 개행 경계에서 대략 같은 크기의 chunk로 나눈다 (병렬 파싱용).
+std::vector<TextChunk> splitIntoChunks(const char* begin, const char* end, size_t chunk_count);
+
+// 헤더 한 줄을 건너뛴 위치를 반환한다.
+const char* skipLine(const char* begin, const char* end);
+
+} // namespace dogm
@@ -1,7 +1,9 @@
 #include "visualizer.h"
+#include "grid_snapshot.h"
+#include "mapped_file.h"
+#include "text_parse.h"
 #include <iostream>
-#include <fstream>
-#include <sstream>
+#include <memory>
 #include <string>
 #include <vector>
 #include <map>
@@ -11,38 +13,71 @@
 using TimedGridData = std::map<double, GridState>;
 
 TimedGridData parse_output_file(const std::string& filepath, int grid_size) {
-    std::ifstream file(filepath);
-    if (!file.is_open()) throw std::runtime_error("Error: Cannot open file " + filepath);
-    
+    std::unique_ptr<dogm::MappedFile> file;
+    try {
+        file.reset(new dogm::MappedFile(filepath));
+    } catch (const std::runtime_error&) {
+        throw std::runtime_error("Error: Cannot open file " + filepath);
+    }
+
     TimedGridData all_data;
-    std::string line;
-    std::getline(file, line); // 헤더 스킵
+    const char* end = file->data() + file->size();
+    dogm::LineCursor cursor(dogm::skipLine(file->data(), end), end); // 헤더 스킵
 
-    while(std::getline(file, line)) {
-        std::stringstream ss(line);
-        std::string token;
+    const char* line_begin;
+    const char* line_end;
+    GridState* current_grid = nullptr;
+    double current_timestamp = 0.0;
+
+    while (cursor.nextLine(line_begin, line_end)) {
+        dogm::FieldParser fields(line_begin, line_end, ',');
         double timestamp;
         int x, y;
         VisGridCell cell;
 
-        std::getline(ss, token, ','); timestamp = std::stod(token);
-        std::getline(ss, token, ','); x = std::stoi(token);
-        std::getline(ss, token, ','); y = std::stoi(token);
-        std::getline(ss, token, ','); cell.occ_prob = std::stof(token);
-        std::getline(ss, token, ','); cell.mean_vel.x() = std::stof(token);
-        std::getline(ss, token, ','); cell.mean_vel.y() = std::stof(token);
+        if (!(fields.next(timestamp) && fields.next(x) && fields.next(y) && fields.next(cell.occ_prob) &&
+              fields.next(cell.mean_vel.x()) && fields.next(cell.mean_vel.y()))) {
+            continue;
+        }
+
+        // 같은 타임스탬프의 행은 연속되므로 map 조회는 프레임이 바뀔 때만 한다.
+        if (!current_grid || timestamp != current_timestamp) {
+            current_grid = &all_data[timestamp];
+            current_timestamp = timestamp;
+            if (current_grid->empty()) {
+                current_grid->resize(grid_size * grid_size);
+            }
+        }
+        (*current_grid)[y * grid_size + x] = cell;
+    }
+    return all_data;
+}
+
+// .dgrid 스냅샷은 전체 그리드를 담고 있으므로 CSV와 달리 모든 셀이 채워진다.
+TimedGridData read_grid_snapshot(const std::string& filepath, int& grid_size) {
+    dogm::GridSnapshotReader reader(filepath);
+    grid_size = reader.getGridSize();
+    const float velocity_scale = reader.getVelocityScale();
 
-        if (all_data.find(timestamp) == all_data.end()) {
-            all_data[timestamp].resize(grid_size * grid_size);
+    TimedGridData all_data;
+    dogm::GridSnapshotFrame frame;
+    for (size_t i = 0; i < reader.getTotalFrames(); ++i) {
+        reader.readFrame(i, frame);
+        GridState& grid = all_data[frame.timestamp];
+        grid.resize(frame.occupancy.size());
+        for (size_t c = 0; c < grid.size(); ++c) {
+            grid[c].occ_prob = frame.occupancy[c] / 255.0f;
+            grid[c].mean_vel = Eigen::Vector2f(frame.velocity_x[c] / velocity_scale,
+                                               frame.velocity_y[c] / velocity_scale);
         }
-        all_data[timestamp][y * grid_size + x] = cell;
     }
     return all_data;
 }
 
 int main(int argc, char** argv) {
     if (argc < 4) {
-        std::cerr << "Usage: " << argv[0] << " <output_dogm.csv> <grid_size_in_cells> <mode> [output_video.mp4]" << std::endl;
+        std::cerr << "Usage: " << argv[0] << " <output_dogm.csv | output.dgrid> <grid_size_in_cells> <mode> [output_video.mp4]" << std::endl;
+        std::cerr << "For .dgrid input the grid size is read from the file." << std::endl;
         std::cerr << "Modes: --animate OR --view" << std::endl;
         return 1;
     }
@@ -52,7 +87,10 @@ int main(int argc, char** argv) {
     std::string mode = argv[3];
     
     try {
-        TimedGridData data = parse_output_file(input_path, grid_size);
+        TimedGridData data = dogm::GridSnapshotReader::isGridSnapshot(input_path)
+                                 ? read_grid_snapshot(input_path, grid_size)
+                                 : parse_output_file(input_path, grid_size);
+        if (data.empty()) throw std::runtime_error("No frames in " + input_path);
 
         if (mode == "--animate") {
             if (argc != 5) {
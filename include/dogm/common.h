@@ -1,9 +1,12 @@
 #pragma once
 
 #include <algorithm>
-#include <random>
+#include <cstddef>
+#include <cstdint>
 #include <numeric>
 #include <cmath>
+#include <type_traits>
+#include <vector>
 #include <omp.h>
 
 namespace dogm {
@@ -23,10 +26,105 @@ inline unsigned int hash(unsigned int a) {
     return a;
 }
 
+// inclusiveScan의 블록 분할. 블록 크기는 n으로만 정해지므로 결과가 스레드 수와 무관하다.
+constexpr size_t kScanMinBlockSize = 4096;
+constexpr int kScanMaxBlocks = 256;
+constexpr size_t kScanParallelThreshold = size_t(1) << 15;
+
+// Blocked two-pass inclusive scan: out[i] = in[0] + ... + in[i]. in과 out은 같은 배열이어도 된다.
+// (1) 블록 합을 병렬로 구하고 (2) 블록 합을 직렬로 exclusive scan한 뒤 (3) 블록마다 시작값부터 다시 누적한다.
+// 누적은 double(정수는 int64)로 하여 10^6개 float에서도 오차가 쌓이지 않는다. 블록 안에서는 4개씩
+// 지역 누적합을 먼저 만들고 carry를 더해, 직렬 의존 체인을 원소 4개당 덧셈 하나로 줄인다.
+template<typename T>
+void inclusiveScan(const T* in, T* out, size_t n) {
+    using Acc = typename std::conditional<std::is_floating_point<T>::value, double, long long>::type;
+    if (n == 0) return;
+
+    // 블록 크기는 64의 배수 (아래 4-way 루프와 캐시 라인 정렬)
+    const size_t block_size = std::max(kScanMinBlockSize, ((n + kScanMaxBlocks - 1) / kScanMaxBlocks + 63) & ~size_t(63));
+    const int block_count = static_cast<int>((n + block_size - 1) / block_size);
+    const bool parallel = n >= kScanParallelThreshold;
+    Acc block_offsets[kScanMaxBlocks];
+
+    // 마지막 블록의 합은 필요 없다. 누적기 4개로 덧셈 의존 체인을 나눈다.
+    #pragma omp parallel for if(parallel)
+    for (int b = 0; b < block_count - 1; ++b) {
+        Acc sum[4] = {0, 0, 0, 0};
+        const size_t begin = b * block_size;
+        for (size_t i = begin; i < begin + block_size; i += 4) {
+            sum[0] += static_cast<Acc>(in[i]);
+            sum[1] += static_cast<Acc>(in[i + 1]);
+            sum[2] += static_cast<Acc>(in[i + 2]);
+            sum[3] += static_cast<Acc>(in[i + 3]);
+        }
+        block_offsets[b] = (sum[0] + sum[1]) + (sum[2] + sum[3]);
+    }
+
+    Acc running = 0;
+    for (int b = 0; b < block_count; ++b) {
+        const Acc block_sum = block_offsets[b];
+        block_offsets[b] = running;
+        if (b + 1 < block_count) running += block_sum;
+    }
+
+    #pragma omp parallel for if(parallel)
+    for (int b = 0; b < block_count; ++b) {
+        const size_t begin = b * block_size;
+        const size_t end = std::min(n, begin + block_size);
+        Acc carry = block_offsets[b];
+        size_t i = begin;
+        for (; i + 4 <= end; i += 4) {
+            const Acc p0 = static_cast<Acc>(in[i]);
+            const Acc p1 = p0 + static_cast<Acc>(in[i + 1]);
+            const Acc p2 = p1 + static_cast<Acc>(in[i + 2]);
+            const Acc p3 = p2 + static_cast<Acc>(in[i + 3]);
+            out[i] = static_cast<T>(carry + p0);
+            out[i + 1] = static_cast<T>(carry + p1);
+            out[i + 2] = static_cast<T>(carry + p2);
+            out[i + 3] = static_cast<T>(carry + p3);
+            carry += p3;
+        }
+        for (; i < end; ++i) {
+            carry += static_cast<Acc>(in[i]);
+            out[i] = static_cast<T>(carry);
+        }
+    }
+}
+
+// sum_{i<n} term(i)를 double로 누적한다. inclusiveScan과 같은 블록 분할을 쓰고 블록 합을 순서대로
+// 더하므로, OpenMP reduction과 달리 결과가 스레드 수와 무관하다.
+template<typename F>
+double blockedSum(size_t n, F&& term) {
+    if (n == 0) return 0.0;
+    const size_t block_size = std::max(kScanMinBlockSize, ((n + kScanMaxBlocks - 1) / kScanMaxBlocks + 63) & ~size_t(63));
+    const int block_count = static_cast<int>((n + block_size - 1) / block_size);
+    const bool parallel = n >= kScanParallelThreshold;
+    double block_sums[kScanMaxBlocks];
+
+    #pragma omp parallel for if(parallel)
+    for (int b = 0; b < block_count; ++b) {
+        const size_t begin = b * block_size;
+        const size_t end = std::min(n, begin + block_size);
+        double sum = 0.0;
+        for (size_t i = begin; i < end; ++i) sum += term(i);
+        block_sums[b] = sum;
+    }
+
+    double total = 0.0;
+    for (int b = 0; b < block_count; ++b) total += block_sums[b];
+    return total;
+}
+
 template<typename T>
 void accumulate(const std::vector<T>& input, std::vector<T>& output) {
     output.resize(input.size());
-    std::partial_sum(input.begin(), input.end(), output.begin());
+    inclusiveScan(input.data(), output.data(), input.size());
+}
+
+// in-place 누적합
+template<typename T>
+void accumulate(std::vector<T>& values) {
+    inclusiveScan(values.data(), values.data(), values.size());
 }
 
 template<typename T>
@@ -37,21 +135,109 @@ inline T subtract(const std::vector<T>& accum_array, int start_idx, int end_idx)
     return accum_array[end_idx] - accum_array[start_idx - 1];
 }
 
+// 커널별 난수 스트림. 같은 프레임, 같은 파티클 인덱스라도 커널마다 서로 다른 수열을 사용한다.
+enum class RandomStream : uint32_t {
+    InitParticles = 0,
+    Predict = 1,
+    Birth = 2,
+    Resample = 3
+};
+
+// Philox4x32-10 counter-based generator (Salmon et al., "Parallel Random Numbers: As Easy as 1, 2, 3").
+// 출력은 (key, counter)의 순수 함수이므로 공유 상태가 없고 스레드 수와 무관하게 동일한 결과를 낸다.
+inline void philox4x32(const uint32_t ctr_in[4], const uint32_t key_in[2], uint32_t out[4]) {
+    uint32_t c0 = ctr_in[0], c1 = ctr_in[1], c2 = ctr_in[2], c3 = ctr_in[3];
+    uint32_t k0 = key_in[0], k1 = key_in[1];
+    for (int round = 0; round < 10; ++round) {
+        uint64_t p0 = static_cast<uint64_t>(0xD2511F53u) * c0;
+        uint64_t p1 = static_cast<uint64_t>(0xCD9E8D57u) * c2;
+        uint32_t hi0 = static_cast<uint32_t>(p0 >> 32), lo0 = static_cast<uint32_t>(p0);
+        uint32_t hi1 = static_cast<uint32_t>(p1 >> 32), lo1 = static_cast<uint32_t>(p1);
+        c0 = hi1 ^ c1 ^ k0;
+        c1 = lo1;
+        c2 = hi0 ^ c3 ^ k1;
+        c3 = lo0;
+        k0 += 0x9E3779B9u;
+        k1 += 0xBB67AE85u;
+    }
+    out[0] = c0; out[1] = c1; out[2] = c2; out[3] = c3;
+}
+
+// [0, 1) 구간의 float (상위 24비트 사용)
+inline float uint32ToUnitFloat(uint32_t x) {
+    return static_cast<float>(x >> 8) * (1.0f / 16777216.0f);
+}
+
+// (0, 1] 구간의 float. Box-Muller의 log 인자로 사용한다.
+inline float uint32ToOpenUnitFloat(uint32_t x) {
+    return static_cast<float>((x >> 8) + 1u) * (1.0f / 16777216.0f);
+}
+
+// Box-Muller: 균등 난수 2개 -> 표준정규 난수 2개
+inline void boxMuller(uint32_t a, uint32_t b, float& n0, float& n1) {
+    float radius = std::sqrt(-2.0f * std::log(uint32ToOpenUnitFloat(a)));
+    float theta = 6.28318530717958647692f * uint32ToUnitFloat(b);
+    n0 = radius * std::cos(theta);
+    n1 = radius * std::sin(theta);
+}
+
+// Stateless per-particle random numbers.
+// 각 draw는 (seed, frame, stream, index, block)으로 결정되며, 한 번의 Philox 호출로 4개의 값을 만든다.
 class RandomGenerator {
 private:
-    std::mt19937 gen;
-    std::uniform_real_distribution<float> uniform_dist;
-    std::normal_distribution<float> normal_dist;
-    
+    uint32_t seed;
+    uint32_t frame = 0;
+
+    void block(RandomStream stream, uint32_t index, uint32_t block_idx, uint32_t out[4]) const {
+        const uint32_t ctr[4] = {index, block_idx, static_cast<uint32_t>(stream), 0u};
+        const uint32_t key[2] = {seed, frame};
+        philox4x32(ctr, key, out);
+    }
+
 public:
-    RandomGenerator(unsigned int seed = 123456) : gen(seed), uniform_dist(0.0f, 1.0f), normal_dist(0.0f, 1.0f) {}
-    
-    float uniform(float min = 0.0f, float max = 1.0f) {
-        return min + (max - min) * uniform_dist(gen);
-    }
-    
-    float normal(float mean = 0.0f, float stddev = 1.0f) {
-        return mean + stddev * normal_dist(gen);
+    explicit RandomGenerator(unsigned int seed = 123456) : seed(seed) {}
+
+    // 매 프레임 시작 시 호출. 프레임마다 독립된 수열을 사용하게 된다.
+    void setFrame(unsigned int frame_index) { frame = frame_index; }
+    unsigned int getFrame() const { return frame; }
+
+    // index번째 파티클의 균등 난수 4개, 각각 [0, 1)
+    void uniform4(RandomStream stream, uint32_t index, float out[4], uint32_t block_idx = 0) const {
+        uint32_t bits[4];
+        block(stream, index, block_idx, bits);
+        for (int k = 0; k < 4; ++k) {
+            out[k] = uint32ToUnitFloat(bits[k]);
+        }
+    }
+
+    float uniform(RandomStream stream, uint32_t index, float min = 0.0f, float max = 1.0f) const {
+        float u[4];
+        uniform4(stream, index, u);
+        return min + (max - min) * u[0];
+    }
+
+    // index번째 파티클의 표준정규 난수 4개
+    void normal4(RandomStream stream, uint32_t index, float out[4], uint32_t block_idx = 0) const {
+        uint32_t bits[4];
+        block(stream, index, block_idx, bits);
+        boxMuller(bits[0], bits[1], out[0], out[1]);
+        boxMuller(bits[2], bits[3], out[2], out[3]);
+    }
+
+    // Batch sampler: 파티클 [first, first + count) 각각에 대해 표준정규 난수 4개를 성분별 배열
+    // n0..n3[k]에 기록 (planar). normal4와 동일한 값을 내며, 출력이 SoA 열과 같은 모양이라 SIMD 커널이
+    // 바로 load할 수 있다. 루프 자체는 scalar이다: boxMuller의 std::log/cos/sin은 libm 호출이라
+    // (-ffast-math와 libmvec 없이는) 벡터화되지 않으며, predict 시간의 대부분이 여기에 든다.
+    void normal4Batch(RandomStream stream, uint32_t first, size_t count,
+                      float* n0, float* n1, float* n2, float* n3) const {
+        const uint32_t key[2] = {seed, frame};
+        for (size_t k = 0; k < count; ++k) {
+            const uint32_t ctr[4] = {first + static_cast<uint32_t>(k), 0u, static_cast<uint32_t>(stream), 0u};
+            uint32_t bits[4];
+            philox4x32(ctr, key, bits);
+            boxMuller(bits[0], bits[1], n0[k], n1[k]);
+            boxMuller(bits[2], bits[3], n2[k], n3[k]);
+        }
     }
 };
 
@@ -2,10 +2,31 @@
 
 #include "dogm_types.h"
 #include "common.h"
+#include "stats.h"
+#include <chrono>
 #include <memory>
 
 namespace dogm {
 
+namespace kernel {
+struct Workspace;
+}
+
+enum class ResamplingMethod {
+    Multinomial,        // 파티클마다 독립 난수 + 이진 탐색
+    Systematic,         // 난수 하나, 직렬 선형 탐색
+    Stratified,         // 층마다 독립 난수, 병렬 merge path
+    Residual,           // floor(N * w) 결정적 복제 + 나머지 systematic
+    ParallelSystematic  // Systematic과 같은 결과, 병렬 merge path
+};
+
+// Adaptive particle count에서 다음 파티클 수를 정하는 기준
+enum class ParticleCountCriterion {
+    EffectiveSampleSize,  // ESS / N이 목표 비율을 유지하도록
+    OccupiedCells,        // 점유 셀 수에 비례
+    KLD                   // KLD-sampling (Fox, 2003): 파티클이 있는 셀 수 기반
+};
+
 class DOGM {
 public:
     struct Params {
@@ -20,48 +41,171 @@ public:
         float stddev_velocity = 1.0f;         // 1 m/s for indoor
         float init_max_velocity = 3.0f;       // 3 m/s max
         float freespace_discount = 0.01f;
+        // 같은 seed와 입력이면 결과는 스레드 수, SIMD 수준과 무관하게 bit 단위로 같다 (dogm_regress로 확인)
+        unsigned int random_seed = 123456;    // Counter-based RNG key
+        ResamplingMethod resampling_method = ResamplingMethod::Multinomial;
+        
+        // true면 그리드 창의 중심이 ego_pose를 셀 단위로 따라간다 (vehicle-centred grid).
+        // false면 창은 월드 원점 [0, size)에 고정된다.
+        bool follow_ego = false;
+        
+        // true면 occupancy/persistent/moments를 셀 단위 fused 커널 하나로 처리한다 (kernel::updateCellsFused).
+        bool fused_cell_update = true;
+        
+        // true면 fused 갱신을 파티클 또는 측정이 있는 셀에만 적용한다 (fused_cell_update일 때만).
+        // 비활성 셀의 free_mass decay는 다시 활성화되거나 getGridCells()로 읽힐 때 닫힌 형태로 적용된다.
+        bool sparse_cells = true;
+        
+        // grid_cells/meas_cells의 저장 순서. Tiled/Morton은 이웃 셀을 같은 캐시 라인/페이지에 모아
+        // 파티클 -> 셀 조회의 locality를 높인다. 파티클 정렬 순서가 바뀌므로 난수 배정과 결과가 달라진다.
+        GridLayout grid_layout = GridLayout::RowMajor;
+        
+        // Radar 검출을 반경 radar_splat_radius 셀의 Gaussian footprint(표준편차 radar_splat_sigma 셀)로
+        // 퍼뜨린다. 0이면 검출 셀 하나에만 기록한다.
+        int radar_splat_radius = 1;
+        float radar_splat_sigma = 0.6f;
+        
+        // Adaptive particle count: resampling 시 [min, max] 범위에서 다음 프레임의 파티클 수를 고른다.
+        // 신생 파티클 수는 particle_count 대비 new_born_particle_count 비율을 유지한다.
+        bool adaptive_particle_count = false;
+        ParticleCountCriterion particle_count_criterion = ParticleCountCriterion::KLD;
+        int min_particle_count = 2000;
+        int max_particle_count = 200000;
+        float target_ess_ratio = 0.5f;              // EffectiveSampleSize
+        float particles_per_occupied_cell = 200.0f; // OccupiedCells
+        float occupied_mass_threshold = 0.2f;       // OccupiedCells
+        float kld_epsilon = 0.05f;                  // KLD: 허용 KL 오차
+        float kld_z = 2.326f;                       // KLD: 표준정규 상위 분위수 (1 - delta = 0.99)
+        float particle_count_smoothing = 0.5f;      // 목표 수로 한 프레임에 이동하는 비율
+        float capacity_hysteresis = 0.25f;
+        // true면 adaptive 모드의 파티클 버퍼를 max_particle_count 용량으로 미리 잡고 줄이지 않는다
+        // (첫 프레임 이후 updateGrid 중 힙 할당 없음). false면 capacity_hysteresis로 늘리고 줄인다.
+        bool reserve_max_particles = true;
+        int stats_histogram_window = 0;       // >0이면 최근 N 프레임의 latency histogram 유지
+        
+        // true면 프레임 사이의 파티클 상태를 CompactParticlesSoA(14 B/파티클)로 보관한다.
+        // predict는 compact 상태에서 돌고, particleToGrid가 float 작업 집합으로 복원하며 정렬하고,
+        // resampling이 다시 부호화한다. 셀 단계는 float 그대로다. 양자화 때문에 float 경로와 결과가 다르다.
+        bool compact_particle_state = false;
+        
+        // >0이면 ego pose 중심, 한 변 inner_size [m] 정사각형 안의 셀은 더 세밀한 그리드가 담당한다
+        // (DOGMMultiRes의 바깥 level). 그 셀의 측정은 버리고 파티클 가중치는 0으로 만들어, 측정 처리,
+        // 신생 파티클, 셀 갱신이 바깥 고리에만 쓰인다.
+        float inner_size = 0.0f;
     };
     
     DOGM(const Params& params);
     ~DOGM();
     
     void updateGrid(const SensorFrame& frame, float dt);
+    void updateGrid(const SensorFrameView& frame, float dt);
     
-    const std::vector<GridCell>& getGridCells() const { return grid_cells; }
+    // sparse_cells면 비활성 셀의 밀린 decay를 적용한 뒤 돌려준다.
+    // 인덱스는 getGridWindow().physicalIndex(x, y), 크기는 패딩을 포함한 getGridWindow().storageSize().
+    const std::vector<GridCell>& getGridCells() const;
+    // 셀별 속도 모멘트 (getGridCells()와 같은 인덱스)
+    const std::vector<GridCellMoments>& getGridMoments() const;
     const std::vector<MeasurementCell>& getMeasurementCells() const { return meas_cells; }
+    // compact_particle_state면 마지막 프레임의 정렬된 float 작업 집합 (resampling 전)
     const ParticlesSoA& getParticles() const { return particles; }
+    const CompactParticlesSoA& getCompactParticles() const { return compact_particles; }
+    int getParticleCount() const {
+        return static_cast<int>(params.compact_particle_state ? compact_particles.size() : particles.size());
+    }
+    
+    // 마지막 updateGrid의 계측 결과 (DOGM_ENABLE_STATS=0이면 항상 0)
+    const DOGMStats& getStats() const { return stats; }
+    const LatencyHistogram& getLatencyHistogram() const { return latency_histogram; }
     
     int getGridSize() const { return grid_size; }
     float getResolution() const { return params.resolution; }
     
+    // 현재 창 위치와 ring buffer offset. getGridCells()[window.physicalIndex(x, y)]가 로컬 셀 (x, y)이다.
+    const GridWindow& getGridWindow() const { return window; }
+    
+    // 마지막 updateGrid에서 갱신한 셀 수 (dense면 전체 셀 수)
+    int getActiveCellCount() const;
+    
 private:
+    friend class DOGMBatch;
+    friend class DOGMPipeline;
+
+    // updateGrid의 단계 묶음. DOGMBatch는 이 단계들을 task DAG로 실행한다:
+    // beginFrame -> { measurementStage, predictionStage } -> cellStage -> resamplingStage
+    // measurementStage와 predictionStage는 서로 다른 버퍼만 쓰므로 동시에 실행할 수 있다.
+    void beginFrame(const SensorFrameView& frame);
+    void measurementStage(const SensorFrameView& frame);
+    void predictionStage(float dt);
+    void cellStage(float dt);
+    void resamplingStage();
+
+    // 측정 그리드 이중 버퍼 (DOGMPipeline). buildPendingMeasurementGrid는 frame의 창 위치로 back 버퍼를
+    // 채우며 DOGM의 다른 상태는 읽거나 쓰지 않으므로 이전 프레임의 단계들과 동시에 실행할 수 있다.
+    // swapInPendingMeasurementGrid는 beginFrame 이후 measurementStage 대신 호출한다.
+    GridWindow windowFor(const Vec2& pose) const;
+    void buildPendingMeasurementGrid(const SensorFrameView& frame);
+    void swapInPendingMeasurementGrid();
+
     void initialize();
-    void updateMeasurementGrid(const SensorFrame& frame);
+    void egoMotionCompensation();
+    void updateMeasurementGrid(const SensorFrameView& frame);
     void particlePrediction(float dt);
     void particleAssignment();
     void gridCellOccupancyUpdate(float dt);
+    void fusedCellUpdate(float dt);
     void updatePersistentParticles();
+    void applyPendingDecay() const;
+    bool sparseCells() const { return params.sparse_cells && params.fused_cell_update; }
     void initializeNewParticles();
     void statisticalMoments();
     void resampling();
+    void adaptParticleCount();
+    float jointEffectiveSampleSize() const;
+    void collectPredictionStats();
+    void collectMeasurementStats();
+    void collectResamplingStats();
+    void resizeParticleBuffer(ParticlesSoA& buffer, size_t count);
+    void resizeParticleBuffer(CompactParticlesSoA& buffer, size_t count);
+    void resizeParticleBuffer(std::vector<float>& buffer, size_t count);
     
     Params params;
     int grid_size;
-    int grid_cell_count;
+    GridWindow window;
+    int grid_cell_count;  // window.storageSize()
     
-    std::vector<GridCell> grid_cells;
+    // sparse 모드의 밀린 decay는 getGridCells()/getGridMoments()에서 적용
+    mutable std::vector<GridCell> grid_cells;
+    mutable std::vector<GridCellMoments> grid_moments;
     std::vector<MeasurementCell> meas_cells;
     
     ParticlesSoA particles;
     ParticlesSoA particles_next;
     ParticlesSoA birth_particles;
+    CompactParticlesSoA compact_particles;  // compact_particle_state일 때 프레임 사이의 상태 (particles_next는 쓰지 않음)
     
     std::vector<float> weight_array;
     std::vector<float> birth_weight_array;
     std::vector<float> born_masses_array;
     
+    ActiveCells measured_cells;   // 측정이 있는 셀
+    ActiveCells particle_cells;   // 파티클이 있는 셀
+    ActiveCells active_cells;     // 둘의 합집합 (sparse 갱신 대상)
+    
+    // DOGMPipeline이 다음 프레임을 위해 미리 만든 측정 그리드 (처음 쓸 때 할당)
+    std::vector<MeasurementCell> pending_meas_cells;
+    ActiveCells pending_measured_cells;
+    double pending_measurement_ms = 0.0;
+    
+    std::unique_ptr<kernel::Workspace> workspace;  // 커널 scratch, initialize()에서 최대 크기로 잡는다
     std::unique_ptr<RandomGenerator> rng;
     
+    DOGMStats stats;
+    LatencyHistogram latency_histogram;
+    std::chrono::steady_clock::time_point frame_start;
+    
+    unsigned int frame_index = 0;
+    double grid_time = 0.0;             // 누적 dt [s]
+    mutable double decayed_time = 0.0;  // 모든 셀이 decay된 시각
     bool first_update = true;
     Vec2 ego_pose;
     float ego_yaw = 0.0f;
@@ -0,0 +1,42 @@
+#pragma once
+
+#include "dogm.h"
+#include <memory>
+#include <vector>
+
+namespace dogm {
+
+// 여러 DOGM 인스턴스(센서 rig별, A/B 파라미터별)를 한 프로세스에서 함께 진행한다.
+// 각 그리드의 updateGrid 단계는 OpenMP task DAG로 표현되어 하나의 스레드 팀(공유 task pool)에서
+// 실행된다. task 안의 커널 parallel 영역은 중첩되지 않고 직렬로 돌기 때문에 인스턴스마다 스레드 팀을
+// 여는 경우와 달리 oversubscription이 없다. 결과는 그리드별 updateGrid와 bit 단위로 같다.
+//
+// 병렬성은 그리드 수(그리드당 최대 두 단계 동시)에서 나오므로 그리드 수가 스레드 수 이상일 때 유리하다.
+// 그리드가 하나면 updateGrid를 그대로 호출한다.
+class DOGMBatch {
+public:
+    DOGMBatch() = default;
+    explicit DOGMBatch(const std::vector<DOGM::Params>& params);
+
+    // 그리드를 추가하고 인덱스를 돌려준다.
+    size_t addGrid(const DOGM::Params& params);
+
+    size_t size() const { return grids.size(); }
+    DOGM& grid(size_t i) { return *grids[i]; }
+    const DOGM& grid(size_t i) const { return *grids[i]; }
+
+    // frames[i]는 grid i의 입력 (frames.size() == size())
+    void updateGrids(const std::vector<SensorFrameView>& frames, float dt);
+    // 모든 그리드에 같은 입력 (파라미터 A/B 비교)
+    void updateGrids(const SensorFrameView& frame, float dt);
+
+private:
+    // frame_at(i)가 grid i의 입력을 돌려준다
+    template<typename FrameAt>
+    void run(FrameAt frame_at, float dt);
+
+    std::vector<std::unique_ptr<DOGM>> grids;
+    std::vector<char> stage_tokens;  // 그리드별 task 의존성 주소 (kStageTokens개씩)
+};
+
+} // namespace dogm
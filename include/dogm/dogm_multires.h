@@ -0,0 +1,65 @@
+#pragma once
+
+#include "dogm_batch.h"
+#include <vector>
+
+namespace dogm {
+
+// sampleGrid의 출력 셀
+struct GridSample {
+    float occ_mass = 0.0f;
+    float free_mass = 0.0f;
+    float mean_x_vel = 0.0f;   // occ_mass 가중 평균 (getGridMoments와 같은 단위)
+    float mean_y_vel = 0.0f;
+    int level = -1;            // 셀 중심을 덮는 가장 세밀한 level (-1이면 어느 level의 창에도 없음)
+};
+
+// Ego 중심의 동심 다해상도 그리드. level 0이 가장 세밀하고 좁으며, 바깥 level일수록 넓고 성기다.
+// 각 level은 follow_ego DOGM 하나이고, level i는 inner_size로 level i - 1이 덮는 안쪽 영역을 비워 둔다.
+// 따라서 측정은 위치에 맞는 level 하나에만 래스터화되고, 파티클은 자기 level의 고리 안에만 있다.
+// 고리 경계를 넘는 물체는 건너간 level의 신생 파티클로 다시 시작한다 (level 간 파티클 이동은 없다).
+//
+// 예: 60 m 창을 0.1 m 한 장으로 두면 360k 셀이지만, 15 m @ 0.1 m + 30 m @ 0.2 m + 60 m @ 0.4 m는
+// level마다 150 x 150 = 68k 셀이다.
+class DOGMMultiRes {
+public:
+    struct Level {
+        float size = 0.0f;         // 창 한 변 [m]
+        float resolution = 0.0f;   // [m]
+        int particle_count = 0;
+        int new_born_particle_count = 0;
+    };
+
+    struct Params {
+        // 모든 level의 공통 설정. size, resolution, 파티클 수, follow_ego, inner_size는 level마다 정해진다.
+        DOGM::Params grid;
+        // 안쪽(가장 세밀한) level부터, size가 커지는 순서
+        std::vector<Level> levels;
+    };
+
+    explicit DOGMMultiRes(const Params& params);
+
+    // 모든 level을 같은 프레임으로 갱신한다 (DOGMBatch의 공유 스레드 팀에서)
+    void updateGrid(const SensorFrame& frame, float dt);
+    void updateGrid(const SensorFrameView& frame, float dt);
+
+    int getLevelCount() const { return static_cast<int>(batch.size()); }
+    const DOGM& getLevel(int level) const { return batch.grid(level); }
+
+    // 모든 level의 셀 수 합 (패딩 제외)
+    int getCellCount() const;
+    // 마지막 updateGrid에서 갱신한 셀 수 합
+    int getActiveCellCount() const;
+
+    // 마지막 프레임의 ego pose 중심, 한 변 size [m]를 resolution [m] 셀로 다시 샘플링한다.
+    // samples는 n x n row-major (n = size / resolution), 셀 (0, 0)의 월드 좌표는 ego_pose - size / 2.
+    // 출력 셀이 원본 셀보다 크면 출력 셀 안의 원본 셀들을 평균하고, 작으면 가장 가까운 원본 셀을 쓴다.
+    // 각 샘플 점은 그 점을 덮는 가장 세밀한 level에서 읽는다.
+    void sampleGrid(float resolution, float size, std::vector<GridSample>& samples) const;
+
+private:
+    DOGMBatch batch;
+    Vec2 center = Vec2::Zero();
+};
+
+} // namespace dogm
@@ -0,0 +1,75 @@
+#pragma once
+
+#include "dogm.h"
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <thread>
+
+namespace dogm {
+
+// 비동기 updateGrid. submitFrame은 프레임을 큐에 넣고 바로 돌아오며, 두 스레드가 단계를 겹쳐 실행한다.
+//  - 측정 스레드: 프레임 N의 측정 그리드를 back 버퍼에 만든다. 프레임 N의 prediction과, 큐가 차 있으면
+//    프레임 N-1의 cell update/resampling과 겹친다.
+//  - 갱신 스레드: beginFrame -> prediction/assignment -> (측정 그리드 swap) -> cell update -> resampling.
+// 창 위치는 절대 ego pose만으로 정해지므로 측정 그리드를 미리 만들어도 결과는 updateGrid를 차례로
+// 부른 것과 bit 단위로 같다.
+//
+// 프레임이 가리키는 센서 데이터는 해당 future가 준비될 때까지 유지되어야 한다.
+// grid()는 처리 중인 프레임이 없을 때(waitIdle 이후)만 읽을 수 있다. 프레임마다 결과가 필요하면
+// 프레임 콜백을 쓴다. 콜백은 갱신 스레드에서 프레임 완료 직후, future가 준비되기 전에 호출된다.
+class DOGMPipeline {
+public:
+    using FrameCallback = std::function<void(const DOGM&)>;
+
+    // measurement_threads: 측정 스레드의 OpenMP 스레드 수. 갱신 스레드의 커널과 동시에 돌기 때문에
+    // 작게 두어 oversubscription을 줄인다.
+    explicit DOGMPipeline(const DOGM::Params& params, int measurement_threads = 1);
+    // 제출된 프레임을 모두 처리한 뒤 스레드를 종료한다.
+    ~DOGMPipeline();
+
+    DOGMPipeline(const DOGMPipeline&) = delete;
+    DOGMPipeline& operator=(const DOGMPipeline&) = delete;
+
+    // 첫 submitFrame 전에 설정한다.
+    void setFrameCallback(FrameCallback callback) { frame_callback = std::move(callback); }
+
+    std::future<void> submitFrame(const SensorFrameView& frame, float dt);
+    void waitIdle();
+
+    const DOGM& grid() const { return dogm; }
+
+private:
+    struct Job {
+        SensorFrameView frame;
+        float dt = 0.0f;
+        std::promise<void> done;
+        std::exception_ptr measurement_error;
+    };
+
+    void updateLoop();
+    void measurementLoop();
+    Job& job(uint64_t seq) { return jobs[static_cast<size_t>(seq - completed)]; }
+
+    DOGM dogm;
+    int measurement_threads;
+    FrameCallback frame_callback;
+
+    std::mutex mutex;
+    std::condition_variable changed;
+    std::deque<Job> jobs;       // 끝나지 않은 프레임, front의 순번은 completed
+    uint64_t submitted = 0;     // 제출된 프레임 수
+    uint64_t measured = 0;      // 측정 그리드를 만든 프레임 수
+    uint64_t swapped = 0;       // 측정 그리드를 가져간 프레임 수 (measured - swapped <= 1: back 버퍼 하나)
+    uint64_t completed = 0;     // 끝난 프레임 수
+    bool stopping = false;
+
+    std::thread measurement_thread;
+    std::thread update_thread;
+};
+
+} // namespace dogm
@@ -1,13 +1,19 @@
 #pragma once
 
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <new>
 #include <vector>
 #include <Eigen/Dense>
+#include "grid_layout.h"
 
 namespace dogm {
 
 using Vec2 = Eigen::Vector2f;
 using Vec4 = Eigen::Vector4f;
 
+// 셀 갱신 커널과 파티클->셀 조회가 매 프레임 읽고 쓰는 필드 (hot). 속도 모멘트는 GridCellMoments에 따로 둔다.
 struct GridCell {
     int start_idx = -1;
     int end_idx = -1;
@@ -19,6 +25,13 @@ struct GridCell {
     float mu_A = 0.0f;
     float mu_UA = 0.0f;
     
+    // 마지막으로 갱신된 grid 시간 [s]. 그 뒤로 비활성(파티클, 측정 없음)이었던 셀에는
+    // free_mass decay가 다음에 읽힐 때 닫힌 형태로 한 번에 적용된다.
+    double last_update_time = 0.0;
+};
+
+// 셀별 속도 통계 (cold). 출력용으로만 읽히며 grid_cells와 같은 인덱스를 쓴다.
+struct GridCellMoments {
     float mean_x_vel = 0.0f;
     float mean_y_vel = 0.0f;
     float var_x_vel = 0.0f;
@@ -33,8 +46,203 @@ struct MeasurementCell {
     float p_A = 1.0f;
     
     // Radar 퓨전용 데이터
-    float radial_velocity = 0.0f;
+    float radial_velocity = 0.0f;       // SNR 가중 평균 [m/s]
     float velocity_confidence = 0.0f;
+    float radial_velocity_var = 0.0f;   // Doppler likelihood 분산 (측정 잡음 + 셀에 모인 검출 간 분산)
+    float los_x = 0.0f;                 // ego -> 검출 시선 단위 벡터 (SNR 가중 평균)
+    float los_y = 0.0f;
+};
+
+// 16비트 값의 비트 사이에 0을 끼워 넣는다 (Morton 부호화). 역연산은 compactBits16.
+inline uint32_t spreadBits16(uint32_t v) {
+    v = (v | (v << 8)) & 0x00FF00FFu;
+    v = (v | (v << 4)) & 0x0F0F0F0Fu;
+    v = (v | (v << 2)) & 0x33333333u;
+    v = (v | (v << 1)) & 0x55555555u;
+    return v;
+}
+
+inline uint32_t compactBits16(uint32_t v) {
+    v &= 0x55555555u;
+    v = (v | (v >> 1)) & 0x33333333u;
+    v = (v | (v >> 2)) & 0x0F0F0F0Fu;
+    v = (v | (v >> 4)) & 0x00FF00FFu;
+    v = (v | (v >> 8)) & 0x0000FFFFu;
+    return v;
+}
+
+// 저장 좌표 (px, py) <-> 배열 인덱스. Tiled는 한 변을 8의 배수로, Morton은 2의 거듭제곱으로 올리므로
+// 배열 크기(storage_size)가 grid_size^2보다 클 수 있다. 패딩 셀에는 파티클도 측정도 들어가지 않는다.
+struct GridIndexer {
+    static constexpr int kTileShift = 3;  // 8x8 타일
+    static constexpr int kTileSize = 1 << kTileShift;
+
+    GridLayout layout = GridLayout::RowMajor;
+    int grid_size = 0;
+    int tiles_per_row = 0;
+    int storage_size = 0;
+
+    GridIndexer() = default;
+    GridIndexer(int grid_size, GridLayout layout) : layout(layout), grid_size(grid_size) {
+        tiles_per_row = (grid_size + kTileSize - 1) >> kTileShift;
+        switch (layout) {
+        case GridLayout::RowMajor:
+            storage_size = grid_size * grid_size;
+            break;
+        case GridLayout::Tiled:
+            storage_size = tiles_per_row * tiles_per_row * kTileSize * kTileSize;
+            break;
+        case GridLayout::Morton: {
+            int extent = 1;
+            while (extent < grid_size) extent <<= 1;
+            storage_size = extent * extent;
+            break;
+        }
+        }
+    }
+
+    int index(int px, int py) const {
+        switch (layout) {
+        case GridLayout::Tiled: {
+            const int tile = (py >> kTileShift) * tiles_per_row + (px >> kTileShift);
+            return (tile << (2 * kTileShift)) | ((py & (kTileSize - 1)) << kTileShift) | (px & (kTileSize - 1));
+        }
+        case GridLayout::Morton:
+            return static_cast<int>(spreadBits16(px) | (spreadBits16(py) << 1));
+        default:
+            return py * grid_size + px;
+        }
+    }
+
+    void coords(int idx, int& px, int& py) const {
+        switch (layout) {
+        case GridLayout::Tiled: {
+            const int tile = idx >> (2 * kTileShift);
+            px = ((tile % tiles_per_row) << kTileShift) | (idx & (kTileSize - 1));
+            py = ((tile / tiles_per_row) << kTileShift) | ((idx >> kTileShift) & (kTileSize - 1));
+            break;
+        }
+        case GridLayout::Morton:
+            px = static_cast<int>(compactBits16(idx));
+            py = static_cast<int>(compactBits16(idx >> 1));
+            break;
+        default:
+            px = idx % grid_size;
+            py = idx / grid_size;
+            break;
+        }
+    }
+};
+
+// Vehicle-centred grid의 창(window)과 ring buffer 매핑.
+// 창은 월드 셀 [origin, origin + grid_size)를 덮고, 월드 셀 c는 항상 저장 좌표 (c mod grid_size)에
+// 놓인다. 따라서 창이 이동해도 셀을 복사하지 않고 offset만 바뀌며, 새로 들어온 가장자리 셀만 초기화하면 된다.
+// 저장 좌표에서 배열 인덱스로의 변환은 indexer(GridLayout)가 맡는다.
+// 파티클 좌표와 커널의 셀 좌표는 창 기준 로컬 좌표(셀 단위, [0, grid_size))이다.
+struct GridWindow {
+    int grid_size = 0;
+    float resolution = 1.0f;
+    int origin_x = 0;  // 로컬 셀 (0, 0)의 월드 셀 좌표
+    int origin_y = 0;
+    int offset_x = 0;  // 로컬 셀 (0, 0)의 저장 좌표 = origin mod grid_size
+    int offset_y = 0;
+    GridIndexer indexer;
+
+    GridWindow() = default;
+    GridWindow(int grid_size, float resolution, GridLayout layout = GridLayout::RowMajor)
+        : grid_size(grid_size), resolution(resolution), indexer(grid_size, layout) {}
+
+    void moveTo(int new_origin_x, int new_origin_y) {
+        origin_x = new_origin_x;
+        origin_y = new_origin_y;
+        offset_x = ((origin_x % grid_size) + grid_size) % grid_size;
+        offset_y = ((origin_y % grid_size) + grid_size) % grid_size;
+    }
+
+    // grid_cells/meas_cells 배열 크기 (패딩 포함)
+    int storageSize() const { return indexer.storage_size; }
+
+    // 창 원점의 월드 좌표 [m]
+    Vec2 originMeters() const { return Vec2(origin_x * resolution, origin_y * resolution); }
+
+    int physicalX(int local_x) const {
+        int x = local_x + offset_x;
+        return x >= grid_size ? x - grid_size : x;
+    }
+    int physicalY(int local_y) const {
+        int y = local_y + offset_y;
+        return y >= grid_size ? y - grid_size : y;
+    }
+
+    // 로컬 셀 (x, y) -> grid_cells/meas_cells 인덱스. 0 <= x, y < grid_size
+    int physicalIndex(int local_x, int local_y) const {
+        return indexer.index(physicalX(local_x), physicalY(local_y));
+    }
+
+    // grid_cells/meas_cells 인덱스 -> 로컬 셀 좌표 (패딩이 아닌 셀에 대해서만 의미가 있다)
+    void localCoords(int physical_idx, int& local_x, int& local_y) const {
+        indexer.coords(physical_idx, local_x, local_y);
+        local_x -= offset_x;
+        local_y -= offset_y;
+        if (local_x < 0) local_x += grid_size;
+        if (local_y < 0) local_y += grid_size;
+    }
+};
+
+// 로컬 셀 사각형 [x0, x1) x [y0, y1)
+struct CellRect {
+    int x0 = 0;
+    int y0 = 0;
+    int x1 = 0;
+    int y1 = 0;
+
+    bool empty() const { return x0 >= x1 || y0 >= y1; }
+    bool contains(int x, int y) const { return x >= x0 && x < x1 && y >= y0 && y < y1; }
+};
+
+// 셀 집합: 64셀 단위 bitmap과 셀 인덱스 오름차순 목록.
+// 희소한 장면에서 셀 커널이 전체 그리드 대신 이 목록만 순회한다. bitmap word 경계로 나눈
+// 병렬 루프(schedule(static, 64))에서는 원자 연산 없이 set할 수 있다.
+struct ActiveCells {
+    std::vector<uint64_t> bits;
+    std::vector<int> list;
+
+    // list는 최대 크기로 미리 잡아 두어 buildList가 할당하지 않게 한다
+    void resize(size_t cell_count) {
+        bits.assign((cell_count + 63) / 64, 0);
+        list.clear();
+        list.reserve(cell_count);
+    }
+
+    bool contains(int cell) const { return (bits[cell >> 6] >> (cell & 63)) & 1u; }
+    void set(int cell) { bits[cell >> 6] |= uint64_t(1) << (cell & 63); }
+
+    // list와 bitmap이 일치한다고 보고 list가 가리키는 word만 지운다. O(활성 셀 수)
+    void clear() {
+        for (int cell : list) bits[cell >> 6] = 0;
+        list.clear();
+    }
+
+    // bitmap으로부터 list를 다시 만든다. O(셀 수 / 64 + 활성 셀 수)
+    void buildList() {
+        list.clear();
+        for (size_t w = 0; w < bits.size(); ++w) {
+            uint64_t word = bits[w];
+            while (word) {
+                list.push_back(static_cast<int>(w * 64 + __builtin_ctzll(word)));
+                word &= word - 1;
+            }
+        }
+    }
+
+    // this = a ∪ b (bitmap word OR 후 list 재구성)
+    void assignUnion(const ActiveCells& a, const ActiveCells& b) {
+        bits.resize(a.bits.size());
+        for (size_t w = 0; w < bits.size(); ++w) {
+            bits[w] = a.bits[w] | b.bits[w];
+        }
+        buildList();
+    }
 };
 
 struct Particle {
@@ -43,18 +251,153 @@ struct Particle {
     float weight;
 };
 
-// Structure of Arrays (SoA) for cache-friendly CPU processing
+// 캐시 라인(64B) 정렬 할당자. SIMD 커널이 열(column) 시작 주소를 정렬된 것으로 가정할 수 있게 한다.
+template<typename T, size_t Alignment = 64>
+struct AlignedAllocator {
+    using value_type = T;
+    template<typename U> struct rebind { using other = AlignedAllocator<U, Alignment>; };
+
+    AlignedAllocator() noexcept = default;
+    template<typename U>
+    AlignedAllocator(const AlignedAllocator<U, Alignment>&) noexcept {}
+
+    T* allocate(size_t n) {
+        return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t(Alignment)));
+    }
+    void deallocate(T* p, size_t) noexcept {
+        ::operator delete(p, std::align_val_t(Alignment));
+    }
+
+    template<typename U>
+    bool operator==(const AlignedAllocator<U, Alignment>&) const noexcept { return true; }
+    template<typename U>
+    bool operator!=(const AlignedAllocator<U, Alignment>&) const noexcept { return false; }
+};
+
+template<typename T>
+using AlignedVector = std::vector<T, AlignedAllocator<T>>;
+
+// 용량 hysteresis를 둔 resize. 늘릴 때는 hysteresis 비율만큼 여유 용량을 확보하고,
+// 크기가 용량의 (1 - 2 * hysteresis) 아래로 줄어들 때만 메모리를 반환한다.
+template<typename T, typename Alloc>
+void resizeWithHysteresis(std::vector<T, Alloc>& vec, size_t new_size, float hysteresis) {
+    const size_t capacity = vec.capacity();
+    const size_t target_capacity = static_cast<size_t>(new_size * (1.0f + hysteresis));
+    if (new_size > capacity) {
+        vec.reserve(target_capacity);
+    } else if (new_size < capacity * (1.0f - 2.0f * hysteresis)) {
+        std::vector<T, Alloc> shrunk;
+        shrunk.reserve(target_capacity);
+        shrunk.assign(vec.begin(), vec.begin() + std::min(vec.size(), new_size));
+        vec.swap(shrunk);
+    }
+    vec.resize(new_size);
+}
+
+// Structure of Arrays (SoA) for cache-friendly CPU processing.
+// 상태 성분마다 독립된 float 열을 두어 predict 등에서 unit-stride SIMD load/store가 가능하다.
 struct ParticlesSoA {
-    std::vector<Vec4> state;
-    std::vector<int> grid_cell_idx;
-    std::vector<float> weight;
-    
-    size_t size() const { return state.size(); }
-    
+    AlignedVector<float> x;
+    AlignedVector<float> y;
+    AlignedVector<float> vx;
+    AlignedVector<float> vy;
+    AlignedVector<int> grid_cell_idx;
+    AlignedVector<float> weight;
+    AlignedVector<char> associated;
+
+    size_t size() const { return x.size(); }
+
     void resize(size_t new_size) {
-        state.resize(new_size);
+        x.resize(new_size);
+        y.resize(new_size);
+        vx.resize(new_size);
+        vy.resize(new_size);
         grid_cell_idx.resize(new_size);
         weight.resize(new_size);
+        associated.resize(new_size);
+    }
+
+    void reserve(size_t capacity) {
+        x.reserve(capacity);
+        y.reserve(capacity);
+        vx.reserve(capacity);
+        vy.reserve(capacity);
+        grid_cell_idx.reserve(capacity);
+        weight.reserve(capacity);
+        associated.reserve(capacity);
+    }
+
+    void resizeWithHysteresis(size_t new_size, float hysteresis) {
+        dogm::resizeWithHysteresis(x, new_size, hysteresis);
+        dogm::resizeWithHysteresis(y, new_size, hysteresis);
+        dogm::resizeWithHysteresis(vx, new_size, hysteresis);
+        dogm::resizeWithHysteresis(vy, new_size, hysteresis);
+        dogm::resizeWithHysteresis(grid_cell_idx, new_size, hysteresis);
+        dogm::resizeWithHysteresis(weight, new_size, hysteresis);
+        dogm::resizeWithHysteresis(associated, new_size, hysteresis);
+    }
+
+    void setState(size_t i, float px, float py, float pvx, float pvy) {
+        x[i] = px;
+        y[i] = py;
+        vx[i] = pvx;
+        vy[i] = pvy;
+    }
+
+    // 상태 성분(x, y, vx, vy)만 복사. 가중치와 인덱스는 호출 측에서 처리한다.
+    void copyStateFrom(size_t dst, const ParticlesSoA& src, size_t src_idx) {
+        x[dst] = src.x[src_idx];
+        y[dst] = src.y[src_idx];
+        vx[dst] = src.vx[src_idx];
+        vy[dst] = src.vy[src_idx];
+    }
+};
+
+// 프레임 사이에 보관하는 압축 파티클 상태 (Params::compact_particle_state). 파티클당 14 B (ParticlesSoA는 25 B).
+//   cell_x, cell_y      int16   창 로컬 셀 좌표 (창 밖 좌표도 표현)
+//   offset_x, offset_y  uint16  셀 안 위치 * 65536 (cell-relative 16.16 고정소수점)
+//   vx, vy              uint16  IEEE binary16 속도 [셀/s]
+//   log_weight          int16   round(log2(weight) * 256), weight 0은 kCompactZeroWeight
+// 부호화는 particle_codec.h. associated는 신생 이후 어떤 커널도 읽지 않으므로 저장하지 않는다.
+struct CompactParticlesSoA {
+    AlignedVector<int16_t> cell_x;
+    AlignedVector<int16_t> cell_y;
+    AlignedVector<uint16_t> offset_x;
+    AlignedVector<uint16_t> offset_y;
+    AlignedVector<uint16_t> vx;
+    AlignedVector<uint16_t> vy;
+    AlignedVector<int16_t> log_weight;
+
+    size_t size() const { return cell_x.size(); }
+
+    void resize(size_t new_size) {
+        cell_x.resize(new_size);
+        cell_y.resize(new_size);
+        offset_x.resize(new_size);
+        offset_y.resize(new_size);
+        vx.resize(new_size);
+        vy.resize(new_size);
+        log_weight.resize(new_size);
+    }
+
+    void reserve(size_t capacity) {
+        cell_x.reserve(capacity);
+        cell_y.reserve(capacity);
+        offset_x.reserve(capacity);
+        offset_y.reserve(capacity);
+        vx.reserve(capacity);
+        vy.reserve(capacity);
+        log_weight.reserve(capacity);
+    }
+
+    void resizeWithHysteresis(size_t new_size, float hysteresis) {
+        dogm::resizeWithHysteresis(cell_x, new_size, hysteresis);
+        dogm::resizeWithHysteresis(cell_y, new_size, hysteresis);
+        dogm::resizeWithHysteresis(offset_x, new_size, hysteresis);
+        dogm::resizeWithHysteresis(offset_y, new_size, hysteresis);
+        dogm::resizeWithHysteresis(vx, new_size, hysteresis);
+        dogm::resizeWithHysteresis(vy, new_size, hysteresis);
+        dogm::resizeWithHysteresis(log_weight, new_size, hysteresis);
     }
 };
 
@@ -77,4 +420,51 @@ struct SensorFrame {
     float ego_yaw;
 };
 
+// 복사 없이 프레임 데이터를 참조하는 뷰 (SensorFrame 또는 memory-mapped 로그).
+// Radar 필드는 float 단위 stride로 접근한다: SensorFrame은 구조체 배열(stride 4),
+// 바이너리 로그는 열 단위 배열(stride 1).
+struct SensorFrameView {
+    double timestamp = 0.0;
+
+    size_t lidar_count = 0;
+    const float* lidar_ranges = nullptr;
+    const float* lidar_angles = nullptr;
+
+    size_t radar_count = 0;
+    size_t radar_stride = 1;
+    const float* radar_x = nullptr;
+    const float* radar_y = nullptr;
+    const float* radar_velocity = nullptr;
+    const float* radar_snr = nullptr;
+
+    Vec2 ego_pose = Vec2::Zero();
+    float ego_yaw = 0.0f;
+
+    SensorFrameView() = default;
+
+    SensorFrameView(const SensorFrame& frame)
+        : timestamp(frame.timestamp),
+          lidar_count(frame.lidar.ranges.size()),
+          lidar_ranges(frame.lidar.ranges.data()),
+          lidar_angles(frame.lidar.angles.data()),
+          radar_count(frame.radar.size()),
+          radar_stride(sizeof(RadarDetection) / sizeof(float)),
+          ego_pose(frame.ego_pose),
+          ego_yaw(frame.ego_yaw) {
+        static_assert(sizeof(RadarDetection) == 4 * sizeof(float), "RadarDetection must be 4 packed floats");
+        if (!frame.radar.empty()) {
+            const RadarDetection& first = frame.radar.front();
+            radar_x = first.position.data();
+            radar_y = first.position.data() + 1;
+            radar_velocity = &first.radial_velocity;
+            radar_snr = &first.snr;
+        }
+    }
+
+    float radarX(size_t i) const { return radar_x[i * radar_stride]; }
+    float radarY(size_t i) const { return radar_y[i * radar_stride]; }
+    float radarVelocity(size_t i) const { return radar_velocity[i * radar_stride]; }
+    float radarSnr(size_t i) const { return radar_snr[i * radar_stride]; }
+};
+
 } // namespace dogm
\ No newline at end of file
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+
+namespace dogm {
+
+// fastExp의 입력 범위. kFastExpMin 미만은 0 (std::exp는 여기서 denormal), kFastExpMax 초과는 포화.
+constexpr float kFastExpMin = -87.33654f;   // ln(FLT_MIN)
+constexpr float kFastExpMax = 88.02969f;    // ln(2^127)
+// [kFastExpMin, kFastExpMax]에서 std::exp 대비 최대 상대 오차 (dogm_math_check가 확인한다)
+constexpr float kFastExpMaxRelError = 2.0e-7f;
+
+// cond ? a : b를 비트 마스크로 고른다. float 삼항 연산자는 -O2(-ftrapping-math)에서 분기로 남거나
+// 한쪽 계산이 분기 안으로 내려가 omp simd 루프의 if-conversion을 막는다.
+inline float selectFloat(bool cond, float a, float b) {
+    const uint32_t mask = 0u - static_cast<uint32_t>(cond);
+    uint32_t a_bits, b_bits;
+    std::memcpy(&a_bits, &a, sizeof(a_bits));
+    std::memcpy(&b_bits, &b, sizeof(b_bits));
+    const uint32_t bits = (a_bits & mask) | (b_bits & ~mask);
+    float result;
+    std::memcpy(&result, &bits, sizeof(result));
+    return result;
+}
+
+// exp(x) 근사 (Cephes expf 다항식). x = n ln2 + r, |r| <= ln2/2로 나눈 뒤 e^r은 6차 다항식으로,
+// 2^n은 지수 비트로 만든다. 분기와 libm 호출이 없어 omp simd 루프에서 벡터화된다 (SSE2부터).
+// 정확히 같은 IEEE 연산만 쓰므로 결과는 scalar/벡터 실행에서 bit 단위로 같다.
+inline float fastExp(float x) {
+    float clamped = selectFloat(x < kFastExpMin, kFastExpMin, x);
+    clamped = selectFloat(clamped > kFastExpMax, kFastExpMax, clamped);
+
+    // n = round(x / ln2): 1.5 * 2^23을 더하면 가수 아래 비트가 반올림되어 n이 가수 하위 비트에 남는다
+    const float kRoundMagic = 12582912.0f;
+    const float shifted = clamped * 1.44269504088896341f + kRoundMagic;
+    const float fn = shifted - kRoundMagic;
+    int32_t n;
+    std::memcpy(&n, &shifted, sizeof(n));
+    n -= 0x4B400000;  // kRoundMagic의 비트 패턴
+
+    // r = x - n ln2 (ln2를 두 부분으로 나눠 정확도 유지)
+    float r = clamped - fn * 0.693359375f;
+    r = r - fn * -2.12194440e-4f;
+
+    float p = 1.9875691500e-4f;
+    p = p * r + 1.3981999507e-3f;
+    p = p * r + 8.3334519073e-3f;
+    p = p * r + 4.1665795894e-2f;
+    p = p * r + 1.6666665459e-1f;
+    p = p * r + 5.0000001201e-1f;
+    const float y = p * r * r + r + 1.0f;
+
+    const int32_t bits = (n + 127) << 23;
+    float scale;
+    std::memcpy(&scale, &bits, sizeof(scale));
+    return selectFloat(x < kFastExpMin, 0.0f, y * scale);
+}
+
+// Radar Doppler likelihood exp(-0.5 d^2 / var). neg_half_inv_var = -0.5 / var는 셀마다 한 번 계산한다.
+inline float dopplerLikelihood(float vx, float vy, float los_x, float los_y, float radial_velocity,
+                               float neg_half_inv_var) {
+    const float diff = vx * los_x + vy * los_y - radial_velocity;
+    return fastExp(diff * diff * neg_half_inv_var);
+}
+
+} // namespace dogm
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <string>
+
+namespace dogm {
+
+// grid_cells/meas_cells의 저장 순서 (GridIndexer 참고)
+enum class GridLayout : int {
+    RowMajor = 0,  // py * grid_size + px
+    Tiled,         // 8x8 타일의 row-major, 타일 안도 row-major. 한 타일 = 64셀
+    Morton         // Z-order (x, y 비트 인터리브)
+};
+
+inline const char* gridLayoutName(GridLayout layout) {
+    switch (layout) {
+    case GridLayout::RowMajor: return "rowmajor";
+    case GridLayout::Tiled:    return "tiled";
+    case GridLayout::Morton:   return "morton";
+    }
+    return "unknown";
+}
+
+// gridLayoutName의 역. 알 수 없는 이름이면 false
+inline bool parseGridLayout(const std::string& name, GridLayout& layout) {
+    for (GridLayout candidate : {GridLayout::RowMajor, GridLayout::Tiled, GridLayout::Morton}) {
+        if (name == gridLayoutName(candidate)) {
+            layout = candidate;
+            return true;
+        }
+    }
+    return false;
+}
+
+} // namespace dogm
@@ -0,0 +1,16 @@
+#pragma once
+
+#include "dogm/dogm.h"
+
+namespace dogm {
+namespace kernel {
+
+// ParticlesSoA <-> CompactParticlesSoA 변환. 위치는 셀 + 2^-16 셀 고정소수점, 속도는 half,
+// 가중치는 log2 * 256 (particle_codec.h). associated는 저장하지 않는다.
+void encodeParticles(const ParticlesSoA& particles, CompactParticlesSoA& compact);
+
+// grid_cell_idx는 window의 저장 위치로 다시 계산하고 associated는 false로 둔다
+void decodeParticles(const CompactParticlesSoA& compact, ParticlesSoA& particles, const GridWindow& window);
+
+} // namespace kernel
+} // namespace dogm
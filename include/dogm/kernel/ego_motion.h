@@ -0,0 +1,20 @@
+#pragma once
+
+#include "dogm/dogm.h"
+
+namespace dogm {
+namespace kernel {
+
+// 창이 (shift_x, shift_y) 셀만큼 이동한 뒤 새로 들어온 가장자리 셀을 초기 상태로 되돌린다.
+// window는 이동 후의 창. 비용은 O((|shift_x| + |shift_y|) * grid_size)이며 나머지 셀은 건드리지 않는다.
+void clearEnteringCells(std::vector<GridCell>& grid_cells, std::vector<GridCellMoments>& grid_moments,
+                        const GridWindow& window, int shift_x, int shift_y);
+
+// 모든 파티클을 (dx, dy) 셀만큼 평행 이동한다. 창 밖으로 나간 파티클은 predict에서 weight 0이 된다.
+void shiftParticles(ParticlesSoA& particles, float dx, float dy);
+
+// Compact 파티클은 셀 좌표만 바꾼다 (셀 안 위치는 그대로). int16 범위로 포화한다.
+void shiftParticles(CompactParticlesSoA& particles, int dx, int dy);
+
+} // namespace kernel
+} // namespace dogm
@@ -1,19 +1,33 @@
 #pragma once
 
-#include "dogm/dogm_types.h"
-#include "dogm/common.h"
+#include "dogm/dogm.h"
 
 namespace dogm {
 namespace kernel {
 
+// initNewParticles의 scratch
+struct BirthWorkspace {
+    std::vector<float> particle_orders_accum;   // born_masses_array 누적합
+};
+
 void initGridCells(std::vector<GridCell>& grid_cells, std::vector<MeasurementCell>& meas_cells);
 
-void initParticles(ParticlesSoA& particles, RandomGenerator& rng, float max_velocity, int grid_size);
+void initParticles(ParticlesSoA& particles, const RandomGenerator& rng, float max_velocity, const GridWindow& window);
+
+// 같은 난수로 뽑은 초기 파티클을 compact 형식으로 쓴다
+void initParticles(CompactParticlesSoA& particles, const RandomGenerator& rng, float max_velocity,
+                   const GridWindow& window);
+
+void initNewParticles(ParticlesSoA& birth_particles, const std::vector<MeasurementCell>& meas_cells,
+                      const std::vector<float>& born_masses_array, const RandomGenerator& rng,
+                      const DOGM::Params& params, const GridWindow& window, BirthWorkspace& workspace);
 
-void initNewParticles(ParticlesSoA& birth_particles, const std::vector<GridCell>& grid_cells,
+// born_masses_array가 active.list 순서의 압축 배열일 때 (updateCellsFusedSparse의 출력).
+// 신생 질량이 0인 셀은 파티클을 만들지 않으므로 dense 버전과 결과가 같다.
+void initNewParticles(ParticlesSoA& birth_particles, const ActiveCells& active,
                       const std::vector<MeasurementCell>& meas_cells,
-                      const std::vector<float>& born_masses_array, RandomGenerator& rng,
-                      const DOGM::Params& params, int grid_size);
+                      const std::vector<float>& born_masses_array, const RandomGenerator& rng,
+                      const DOGM::Params& params, const GridWindow& window, BirthWorkspace& workspace);
 
 } // namespace kernel
 } // namespace dogm
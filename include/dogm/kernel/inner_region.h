@@ -0,0 +1,23 @@
+#pragma once
+
+#include "dogm/dogm.h"
+
+namespace dogm {
+namespace kernel {
+
+// 창 안에서 center [m] 중심, 한 변 size [m]인 정사각형에 완전히 들어가는 셀 (창 범위로 자른다).
+// DOGMMultiRes에서 더 세밀한 level이 담당하는 영역이다.
+CellRect innerRegion(const GridWindow& window, const Vec2& center, float size);
+
+// region 안의 측정을 unknown으로 되돌리고 measured에서 뺀다. 비용은 O(region 셀 수 + 측정 셀 수).
+void clearMeasurements(std::vector<MeasurementCell>& meas_cells, ActiveCells& measured, const GridWindow& window,
+                       const CellRect& region);
+
+// particleToGrid 이후, region 안 셀에 정렬된 파티클의 가중치를 0으로 만든다.
+// 이 파티클들은 resampling에서 선택되지 않으므로 파티클 예산이 region 밖에 쓰인다.
+void clearParticleWeights(ParticlesSoA& particles, std::vector<float>& weight_array,
+                          const std::vector<GridCell>& grid_cells, const GridWindow& window,
+                          const CellRect& region);
+
+} // namespace kernel
+} // namespace dogm
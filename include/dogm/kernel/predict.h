@@ -1,12 +1,27 @@
 #pragma once
 
-#include "dogm/dogm_types.h"
-#include "dogm/common.h"
+#include "dogm/dogm.h"
+#include "dogm/simd.h"
 
 namespace dogm {
 namespace kernel {
 
-void predict(ParticlesSoA& particles, RandomGenerator& rng, const DOGM::Params& params, int grid_size, float dt);
+// 파티클 좌표는 창 기준 로컬 좌표, grid_cell_idx는 ring buffer 저장 위치로 계산된다.
+// detectSimdLevel()로 고른 커널을 사용
+void predict(ParticlesSoA& particles, const RandomGenerator& rng, const DOGM::Params& params,
+             const GridWindow& window, float dt);
+
+// 커널 수준을 직접 지정 (벤치마크/비교용). 지원되지 않는 수준이면 scalar로 대체한다.
+// 모든 수준이 같은 연산 순서(FMA 없음)를 사용하므로 결과는 bit 단위로 같다.
+void predict(ParticlesSoA& particles, const RandomGenerator& rng, const DOGM::Params& params,
+             const GridWindow& window, float dt, SimdLevel level);
+
+// 압축 파티클 (Params::compact_particle_state). 블록마다 float로 풀어 같은 SIMD 커널로 위치와 속도를 갱신한 뒤
+// 다시 부호화한다. 가중치는 건드리지 않으며 persistence와 창 경계는 particleToGrid에서 적용한다.
+void predict(CompactParticlesSoA& particles, const RandomGenerator& rng, const DOGM::Params& params,
+             const GridWindow& window, float dt);
+void predict(CompactParticlesSoA& particles, const RandomGenerator& rng, const DOGM::Params& params,
+             const GridWindow& window, float dt, SimdLevel level);
 
 } // namespace kernel
 } // namespace dogm
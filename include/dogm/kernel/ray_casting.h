@@ -0,0 +1,40 @@
+#pragma once
+
+#include "dogm/dogm_types.h"
+#include <cstdint>
+#include <vector>
+
+namespace dogm {
+namespace kernel {
+
+// Ray casting 결과 셀 라벨. 스레드별 타일에 OR로 누적하므로 병합 순서와 무관하다.
+enum RayCellLabel : uint8_t {
+    RAY_CELL_UNKNOWN = 0,
+    RAY_CELL_FREE = 1,
+    RAY_CELL_OCCUPIED = 2
+};
+
+// castLidarRays의 scratch와 결과. 타일과 라벨은 호출 사이에 touched 셀을 제외하고 항상 0이므로
+// 매 프레임 전체 그리드를 초기화하거나 병합할 필요가 없다.
+// 버퍼 크기는 셀 수와 스레드 수로만 정해지므로 reserve 이후에는 할당하지 않는다.
+struct RayCastWorkspace {
+    std::vector<uint8_t> tiles;                     // 스레드 수 * 셀 수
+    std::vector<uint64_t> thread_touched;           // 스레드 수 * word 수, 이번 호출에서 타일에 표시한 셀 bitmap
+    std::vector<uint8_t> labels;                    // 셀 수, 로컬 셀 라벨
+    ActiveCells touched;                            // 라벨이 0이 아닌 로컬 셀
+    int cell_count = 0;
+    int thread_count = 0;
+
+    // 셀 수가 바뀌거나 스레드 수가 늘었을 때만 버퍼를 다시 잡는다.
+    void reserve(int cells, int threads);
+};
+
+// Amanatides-Woo grid traversal로 Lidar 빔을 그리드에 투영한다.
+// origin은 그리드 좌표계의 센서 위치 [m]. 빔은 병렬로 처리되며 스레드별 타일에 라벨을 기록한 뒤
+// 빔이 지나간 셀만 OR로 병합해 ws.labels와 ws.touched에 쓴다. 비용은 빔이 지나간 셀 수에 비례한다.
+void castLidarRays(const float* ranges, const float* angles, size_t beam_count,
+                   int grid_size, float resolution,
+                   const Vec2& origin, RayCastWorkspace& ws);
+
+} // namespace kernel
+} // namespace dogm
@@ -1,16 +1,48 @@
 #pragma once
 
-#include "dogm/dogm_types.h"
-#include "dogm/common.h"
+#include "dogm/dogm.h"
 
 namespace dogm {
 namespace kernel {
 
+// 프레임 간에 재사용되는 resampling 버퍼
+struct ResamplingWorkspace {
+    std::vector<float> joint_weights;       // [persistent | birth] 가중치
+    std::vector<float> accum_weights;       // joint_weights 누적합
+    std::vector<float> residual_accum;      // Residual: 나머지 가중치 누적합
+    std::vector<int> replication_offsets;   // Residual: 결정적 복제 횟수 누적합
+    std::vector<int> ancestors;             // 새 파티클 i의 조상 인덱스 (joint 기준)
+};
+
+// workspace.accum_weights(joint_weights의 누적합)가 채워져 있어야 한다. 결과는 workspace.ancestors.
+void selectAncestors(ResamplingMethod method, const std::vector<float>& joint_weights, int sample_count,
+                     const RandomGenerator& rng, ResamplingWorkspace& workspace);
+
+struct ParticleCountInputs {
+    int current_count = 0;
+    float effective_sample_size = 0.0f;  // joint weight 기준
+    int joint_count = 0;                 // persistent + birth 파티클 수
+    int occupied_cells = 0;
+    int support_cells = 0;               // 파티클이 하나 이상 있는 셀 수 (KLD bin)
+};
+
+// params.particle_count_criterion에 따라 다음 프레임의 파티클 수를 [min, max] 범위에서 고른다.
+int chooseParticleCount(const DOGM::Params& params, const ParticleCountInputs& inputs);
+
 void resample(const ParticlesSoA& particles, ParticlesSoA& particles_next,
               const ParticlesSoA& birth_particles,
               const std::vector<float>& weight_array,
               const std::vector<float>& birth_weight_array,
-              RandomGenerator& rng, const DOGM::Params& params);
+              const RandomGenerator& rng, const DOGM::Params& params,
+              const GridWindow& window, ResamplingWorkspace& workspace);
+
+// 같은 resampling 결과를 compact 형식으로 쓴다. particles는 particleToGrid가 복원한 float 작업 집합.
+void resample(const ParticlesSoA& particles, CompactParticlesSoA& particles_next,
+              const ParticlesSoA& birth_particles,
+              const std::vector<float>& weight_array,
+              const std::vector<float>& birth_weight_array,
+              const RandomGenerator& rng, const DOGM::Params& params,
+              const GridWindow& window, ResamplingWorkspace& workspace);
 
 } // namespace kernel
 } // namespace dogm
@@ -1,16 +1,49 @@
 #pragma once
 
 #include "dogm/dogm_types.h"
+#include "dogm/kernel/ray_casting.h"
+#include <cstdint>
 #include <vector>
 
 namespace dogm {
 namespace kernel {
 
+// Radar 검출 하나를 퍼뜨리는 셀 단위 Gaussian footprint와 셀별 누적값
+struct RadarWorkspace {
+    struct CellAccum {
+        float weight = 0.0f;        // SNR 신뢰도 * footprint 가중치 합
+        float velocity = 0.0f;      // 가중 radial velocity 합
+        float velocity_sq = 0.0f;
+        float los_x = 0.0f;         // 가중 시선 벡터 합
+        float los_y = 0.0f;
+    };
+
+    int radius = 0;
+    std::vector<float> footprint;   // (2 * radius + 1)^2, 중심 1. 비어 있으면 검출 셀 하나
+    std::vector<CellAccum> accum;   // 셀 수 (저장 위치), 호출 사이에는 0
+    std::vector<int> cells;         // 이번 호출에서 누적한 셀
+
+    // sigma는 셀 단위
+    void configure(int radius, float sigma);
+    void reserve(int cell_count);
+};
+
+// 측정이 없는 셀의 값 (정규화 후 상태: likelihood 1, p_A 0.5)
+MeasurementCell unknownMeasurementCell();
+
 // Lidar와 Radar 데이터를 모두 포함하는 SensorFrame을 인자로 받도록 하고, ego_pose, ego_yaw 추가
+// 센서 좌표와 ego_pose는 월드 좌표 [m]. meas_cells는 window의 ring buffer 배치로 기록된다.
+// measured는 측정이 있는 셀(저장 위치)의 집합으로, 다음 호출에서 그 셀들만 unknown으로 되돌린다.
+// 따라서 빔이 지나간 셀과 radar footprint만 방문하며 비용이 그리드 크기가 아니라 측정량에 비례한다.
+// Radar 셀에는 radial velocity의 SNR 가중 평균/분산과 시선 단위 벡터가 기록되어, 파티클의
+// Doppler likelihood가 삼각함수 없이 내적 하나로 계산된다.
 void fuseAndCreateMeasurementGrid(std::vector<MeasurementCell>& meas_cells,
-                                 const SensorFrame& frame,
-                                 int grid_size, float resolution,
-                                 const Vec2& ego_pose, float ego_yaw);
+                                 const SensorFrameView& frame,
+                                 const GridWindow& window,
+                                 const Vec2& ego_pose, float ego_yaw,
+                                 RayCastWorkspace& rays,
+                                 RadarWorkspace& radar,
+                                 ActiveCells& measured);
 
 } // namespace kernel
-} // namespace dogm
\ No newline at end of file
+} // namespace dogm
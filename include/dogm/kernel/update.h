@@ -1,13 +1,47 @@
 #pragma once
 
-#include "dogm/dogm_types.h"
-#include "dogm/common.h"
+#include "dogm/dogm.h"
+#include <cmath>
 
 namespace dogm {
 namespace kernel {
 
-void particleToGrid(const ParticlesSoA& particles, std::vector<GridCell>& grid_cells,
-                    std::vector<float>& weight_array);
+// particles를 셀 인덱스 순으로 sorted_particles에 정렬(counting sort)하고 셀별 [start_idx, end_idx]를 기록.
+// cell_histogram은 (스레드 수 + 1) * 셀 수 크기의 scratch 버퍼.
+// occupied는 파티클이 있는 셀의 집합이며, 다음 호출에서 그 셀들의 구간만 -1로 되돌린다.
+void particleToGrid(const ParticlesSoA& particles, ParticlesSoA& sorted_particles,
+                    std::vector<GridCell>& grid_cells, std::vector<float>& weight_array,
+                    std::vector<int>& cell_histogram, ActiveCells& occupied);
+
+// Compact 파티클을 복원하면서 정렬한다. sorted_particles는 이번 프레임의 float 작업 집합이 된다.
+// 창 밖 파티클은 weight 0, 나머지는 복원한 weight * persistence (float predict가 하는 가중치 갱신).
+// particle_cells는 파티클 수 크기의 scratch (파티클별 셀 인덱스).
+void particleToGrid(const CompactParticlesSoA& particles, ParticlesSoA& sorted_particles,
+                    std::vector<GridCell>& grid_cells, std::vector<float>& weight_array,
+                    std::vector<int>& cell_histogram, std::vector<int>& particle_cells, ActiveCells& occupied,
+                    const GridWindow& window, float persistence);
+
+// Sparse 갱신의 grid 시간 [s]. previous는 이번 프레임 직전, current는 이번 프레임 시각.
+struct CellClock {
+    double previous = 0.0;
+    double current = 0.0;
+};
+
+// 파티클도 측정도 없는 셀의 dense 갱신은 free_mass *= discount^dt 이고 나머지 질량과 모멘트는 0이다.
+// 마지막 갱신 이후 비활성이던 셀에 그 갱신을 time까지 닫힌 형태로 한 번에 적용한다.
+inline void applyPendingDecay(GridCell& cell, GridCellMoments& moments, double time, float freespace_discount) {
+    if (cell.last_update_time >= time) return;
+    cell.free_mass *= static_cast<float>(std::pow(static_cast<double>(freespace_discount),
+                                                  time - cell.last_update_time));
+    cell.occ_mass = cell.pers_occ_mass = cell.new_born_occ_mass = cell.pred_occ_mass = 0.0f;
+    cell.mu_A = cell.mu_UA = 0.0f;
+    moments = GridCellMoments();
+    cell.last_update_time = time;
+}
+
+// 모든 셀에 밀린 decay를 적용한다 (sparse 갱신 결과를 밖에서 읽기 전에).
+void applyPendingDecay(std::vector<GridCell>& grid_cells, std::vector<GridCellMoments>& grid_moments,
+                       double time, float freespace_discount);
 
 // 'const ParticlesSoA& particles' 인자 제거
 void updateOccupancy(std::vector<GridCell>& grid_cells,
@@ -16,13 +50,30 @@ void updateOccupancy(std::vector<GridCell>& grid_cells,
                      std::vector<float>& born_masses_array,
                      const DOGM::Params& params, float dt);
 
-// 'const Vec2& ego_pose' 인자 추가
+// Radar 셀의 Doppler likelihood는 meas_cells에 캐시된 시선 벡터와 radial velocity 분산을 쓴다.
 void updatePersistent(ParticlesSoA& particles, const std::vector<MeasurementCell>& meas_cells,
-                      std::vector<GridCell>& grid_cells, std::vector<float>& weight_array,
-                      const Vec2& ego_pose);
+                      std::vector<GridCell>& grid_cells, std::vector<float>& weight_array);
+
+void computeStatisticalMoments(const ParticlesSoA& particles, const std::vector<GridCell>& grid_cells,
+                               std::vector<GridCellMoments>& grid_moments, const std::vector<float>& weight_array);
+
+// updateOccupancy + updatePersistent + computeStatisticalMoments를 셀 단위로 합친 커널.
+// 셀마다 정렬된 파티클 구간 [start_idx, end_idx]를 한 번 읽어 예측 질량, Dempster-Shafer 갱신,
+// mu_A/mu_UA, 정규화된 가중치, 속도 모멘트를 캐시 안에서 계산한다. 전역 prefix sum이 필요 없다.
+// staged 커널들과 같은 순서로 연산하므로 결과가 bit 단위로 같다.
+void updateCellsFused(std::vector<GridCell>& grid_cells, std::vector<GridCellMoments>& grid_moments,
+                      const ParticlesSoA& particles,
+                      std::vector<float>& weight_array, const std::vector<MeasurementCell>& meas_cells,
+                      std::vector<float>& born_masses_array, const DOGM::Params& params, float dt);
 
-void computeStatisticalMoments(const ParticlesSoA& particles, std::vector<GridCell>& grid_cells,
-                               const std::vector<float>& weight_array);
+// updateCellsFused를 active(파티클 또는 측정이 있는 셀)에만 적용한다. 나머지 셀은 건드리지 않고
+// last_update_time에 남겨 두며, 다시 활성화되거나 읽힐 때 applyPendingDecay로 따라잡는다.
+// born_masses_array는 active.list 순서의 압축 배열(크기 active.list.size())로 기록된다.
+void updateCellsFusedSparse(std::vector<GridCell>& grid_cells, std::vector<GridCellMoments>& grid_moments,
+                            const ActiveCells& active,
+                            const ParticlesSoA& particles, std::vector<float>& weight_array,
+                            const std::vector<MeasurementCell>& meas_cells, std::vector<float>& born_masses_array,
+                            const DOGM::Params& params, float dt, const CellClock& clock);
 
 } // namespace kernel
 } // namespace dogm
\ No newline at end of file
@@ -0,0 +1,34 @@
+#pragma once
+
+#include "dogm/dogm.h"
+#include "dogm/kernel/init.h"
+#include "dogm/kernel/ray_casting.h"
+#include "dogm/kernel/resampling.h"
+#include "dogm/kernel/sensor_fusion.h"
+#include <vector>
+
+namespace dogm {
+namespace kernel {
+
+// DOGM 하나가 소유하는 커널 scratch 모음. 각 커널은 자기 부분만 빌려 쓴다.
+// reserveWorkspace로 Params에서 정해지는 최대 크기를 미리 잡아 두면 이후 프레임은 힙 할당이 없다.
+struct Workspace {
+    RayCastWorkspace rays;
+    RadarWorkspace radar;
+    ResamplingWorkspace resampling;
+    BirthWorkspace birth;
+    std::vector<int> cell_histogram;   // particleToGrid, (스레드 수 + 1) * 셀 수
+    std::vector<int> compact_cells;    // particleToGrid(compact), 파티클 수
+};
+
+// 프레임 중 가능한 최대 persistent / 신생 파티클 수 (adaptive면 max_particle_count 기준)
+size_t maxParticleCount(const DOGM::Params& params);
+size_t maxBirthParticleCount(const DOGM::Params& params);
+
+// grid_size는 창 한 변의 셀 수, cell_count는 패딩을 포함한 저장 셀 수, threads는 omp_get_max_threads().
+// 실행 중 스레드 수가 늘어나면 해당 커널이 첫 호출에서 다시 잡는다.
+void reserveWorkspace(Workspace& workspace, const DOGM::Params& params, int grid_size, int cell_count,
+                      int threads);
+
+} // namespace kernel
+} // namespace dogm
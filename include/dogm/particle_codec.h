@@ -0,0 +1,92 @@
+#pragma once
+
+#include "fast_math.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+namespace dogm {
+
+// CompactParticlesSoA 필드의 부호화. 위치와 half 변환, decodeLogWeight는 분기 없는 정수/비트 연산이라
+// omp simd 루프에서 벡터화된다. encodeLogWeight는 log2를 쓰므로 커널은 값마다 한 번만 부른다
+// (resampling 뒤 가중치는 모두 같다).
+
+constexpr int16_t kCompactZeroWeight = INT16_MIN;
+constexpr float kCompactLogWeightScale = 256.0f;  // log2 1당 스텝 수 (상대 오차 <= 2^(1/512) - 1 = 0.14%)
+constexpr float kCompactOffsetScale = 65536.0f;   // 셀 안 위치 스텝 수
+
+inline uint32_t floatToBits(float f) {
+    uint32_t bits;
+    std::memcpy(&bits, &f, sizeof(bits));
+    return bits;
+}
+
+inline float bitsToFloat(uint32_t bits) {
+    float f;
+    std::memcpy(&f, &bits, sizeof(f));
+    return f;
+}
+
+// float -> IEEE binary16 (round-to-nearest-even). |f| >= 65520은 inf 대신 최대 유한값 65504로 포화한다.
+inline uint16_t floatToHalf(float f) {
+    const uint32_t bits = floatToBits(f);
+    const uint32_t sign = (bits >> 16) & 0x8000u;
+    const uint32_t magnitude = bits & 0x7fffffffu;
+
+    // 정규 범위: 지수 bias를 127 -> 15로 바꾸고 가수 하위 13비트를 짝수 쪽으로 반올림
+    const uint32_t mantissa_odd = (magnitude >> 13) & 1u;
+    const uint32_t normal = (magnitude - (112u << 23) + 0xfffu + mantissa_odd) >> 13;
+
+    // |f| < 2^-14: 0.5를 더하면 FPU가 half denormal 자리에서 반올림한 가수를 남긴다
+    const uint32_t denormal_magic = 126u << 23;
+    const uint32_t denormal = floatToBits(bitsToFloat(magnitude) + bitsToFloat(denormal_magic)) - denormal_magic;
+
+    const uint32_t denormal_mask = 0u - static_cast<uint32_t>(magnitude < (113u << 23));
+    uint32_t half = (denormal & denormal_mask) | (normal & ~denormal_mask);
+    half = half > 0x7bffu ? 0x7bffu : half;
+    return static_cast<uint16_t>(half | sign);
+}
+
+// IEEE binary16 -> float (정확). floatToHalf는 inf/NaN을 만들지 않는다.
+inline float halfToFloat(uint16_t h) {
+    const uint32_t magnitude = (h & 0x7fffu) << 13;
+    const float normal = bitsToFloat(magnitude + (112u << 23));
+    // 지수가 0이면 (0, denormal) 2^-14 * (1 + m)에서 2^-14를 빼서 정규화한다
+    const float denormal = bitsToFloat(magnitude + (113u << 23)) - bitsToFloat(113u << 23);
+    const float value = selectFloat((magnitude & (0x1fu << 23)) == 0, denormal, normal);
+    return bitsToFloat(floatToBits(value) | ((h & 0x8000u) << 16));
+}
+
+// 로컬 좌표 x [셀] -> 정수 셀과 셀 안 위치. 셀은 int16 범위로 포화하고 위치는 버림으로 양자화한다.
+inline void encodePosition(float x, int16_t& cell, uint16_t& offset) {
+    float clamped = selectFloat(x < -32768.0f, -32768.0f, x);
+    clamped = selectFloat(clamped > 32767.0f, 32767.0f, clamped);
+    int c = static_cast<int>(clamped);
+    c -= clamped < static_cast<float>(c);  // floor
+    int o = static_cast<int>((clamped - static_cast<float>(c)) * kCompactOffsetScale);
+    o = o > 65535 ? 65535 : o;
+    cell = static_cast<int16_t>(c);
+    offset = static_cast<uint16_t>(o);
+}
+
+// 양자화 구간의 중앙으로 복원한다 (오차 <= 2^-17 셀)
+inline float decodePosition(int16_t cell, uint16_t offset) {
+    return static_cast<float>(cell) + (static_cast<float>(offset) + 0.5f) * (1.0f / kCompactOffsetScale);
+}
+
+// weight -> round(log2(weight) * 256). 0 이하(또는 NaN)는 kCompactZeroWeight.
+inline int16_t encodeLogWeight(float weight) {
+    if (!(weight > 0.0f)) return kCompactZeroWeight;
+    float q = std::round(std::log2(weight) * kCompactLogWeightScale);
+    q = std::min(std::max(q, -32767.0f), 32767.0f);
+    return static_cast<int16_t>(q);
+}
+
+// 2^(q / 256). float normal 범위 밖(q < -32256)은 0이 된다.
+inline float decodeLogWeight(int16_t q) {
+    const float kLn2 = 0.693147180559945309f;
+    return selectFloat(q == kCompactZeroWeight, 0.0f, fastExp(static_cast<float>(q) * (kLn2 / kCompactLogWeightScale)));
+}
+
+} // namespace dogm
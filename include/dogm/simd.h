@@ -0,0 +1,28 @@
+#pragma once
+
+namespace dogm {
+
+// 런타임에 선택되는 SIMD 커널 수준
+enum class SimdLevel : int {
+    Scalar = 0,
+    AVX2,
+    AVX512
+};
+
+// 현재 CPU가 지원하고 라이브러리에 컴파일되어 있는 가장 높은 수준.
+// 환경 변수 DOGM_SIMD=scalar|avx2|avx512 로 더 낮은 수준을 강제할 수 있다.
+SimdLevel detectSimdLevel();
+
+// level이 이 빌드/CPU에서 실행 가능한지 여부
+bool isSimdLevelSupported(SimdLevel level);
+
+inline const char* simdLevelName(SimdLevel level) {
+    switch (level) {
+    case SimdLevel::Scalar: return "scalar";
+    case SimdLevel::AVX2:   return "avx2";
+    case SimdLevel::AVX512: return "avx512";
+    }
+    return "unknown";
+}
+
+} // namespace dogm
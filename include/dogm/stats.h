@@ -0,0 +1,106 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// 0으로 빌드하면 스테이지 타이머와 카운터 계산이 모두 제거된다 (getStats()는 0을 반환).
+#ifndef DOGM_ENABLE_STATS
+#define DOGM_ENABLE_STATS 1
+#endif
+
+namespace dogm {
+
+// DOGM::updateGrid의 처리 단계
+enum class Stage : int {
+    EgoMotion = 0,
+    MeasurementGrid,
+    Prediction,
+    Assignment,
+    OccupancyUpdate,
+    PersistentUpdate,
+    NewBornParticles,
+    StatisticalMoments,
+    Resampling
+};
+
+constexpr int kStageCount = 9;
+
+inline const char* stageName(Stage stage) {
+    static const char* names[kStageCount] = {
+        "ego_motion", "measurement_grid", "prediction", "assignment", "occupancy_update",
+        "persistent_update", "new_born_particles", "statistical_moments", "resampling"
+    };
+    return names[static_cast<int>(stage)];
+}
+
+// 한 프레임의 계측 결과
+struct DOGMStats {
+    uint64_t frame = 0;
+    std::array<double, kStageCount> stage_ms{};
+    double total_ms = 0.0;
+
+    int particles_alive = 0;            // predict 이후 weight > 0
+    int particles_out_of_bounds = 0;    // predict 이후 그리드 밖으로 나간 파티클
+    int particles_born = 0;             // weight > 0 인 신생 파티클
+    float effective_sample_size = 0.0f; // resampling 직전 joint weight의 ESS
+
+    int meas_occupied_cells = 0;        // occ_mass > 0
+    int meas_free_cells = 0;            // free_mass > 0
+    int meas_radar_cells = 0;           // velocity_confidence > 0
+};
+
+// 최근 window개 샘플의 백분위수 (p50/p99 등)
+class RollingHistogram {
+public:
+    explicit RollingHistogram(size_t window = 0) { resize(window); }
+
+    void resize(size_t window);
+    void add(double value);
+    // p: 0 ~ 100. 샘플이 없으면 0.
+    double percentile(double p) const;
+    size_t count() const { return filled; }
+
+private:
+    std::vector<double> samples;
+    size_t next = 0;
+    size_t filled = 0;
+};
+
+struct LatencyHistogram {
+    std::array<RollingHistogram, kStageCount> stages;
+    RollingHistogram total;
+
+    void resize(size_t window);
+    void add(const DOGMStats& stats);
+};
+
+#if DOGM_ENABLE_STATS
+
+class ScopedStageTimer {
+public:
+    ScopedStageTimer(DOGMStats& stats, Stage stage)
+        : stats(stats), stage(stage), start(std::chrono::steady_clock::now()) {}
+
+    ~ScopedStageTimer() {
+        auto end = std::chrono::steady_clock::now();
+        stats.stage_ms[static_cast<int>(stage)] += std::chrono::duration<double, std::milli>(end - start).count();
+    }
+
+private:
+    DOGMStats& stats;
+    Stage stage;
+    std::chrono::steady_clock::time_point start;
+};
+
+#define DOGM_STAGE_TIMER(stats, stage) ::dogm::ScopedStageTimer dogm_stage_timer(stats, stage)
+
+#else
+
+#define DOGM_STAGE_TIMER(stats, stage) ((void)0)
+
+#endif
+
+} // namespace dogm
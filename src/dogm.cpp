@@ -1,10 +1,17 @@
 #include "dogm/dogm.h"
+#include "dogm/kernel/ego_motion.h"
 #include "dogm/kernel/init.h"
+#include "dogm/kernel/inner_region.h"
 #include "dogm/kernel/predict.h"
+#include "dogm/kernel/ray_casting.h"
 #include "dogm/kernel/update.h"
 #include "dogm/kernel/resampling.h"
 #include "dogm/kernel/sensor_fusion.h" // sensor_fusion.h 헤더를 포함합니다.
+#include "dogm/kernel/workspace.h"
+#include "dogm/particle_codec.h"
 #include <algorithm>
+#include <chrono>
+#include <cmath>
 #include <numeric>
 
 namespace dogm {
@@ -12,84 +19,455 @@ namespace dogm {
 DOGM::DOGM(const Params& params) 
     : params(params),
       grid_size(static_cast<int>(params.size / params.resolution)),
-      grid_cell_count(grid_size * grid_size),
-      rng(std::make_unique<RandomGenerator>()) {
+      window(grid_size, params.resolution, params.grid_layout),
+      grid_cell_count(window.storageSize()),
+      workspace(std::make_unique<kernel::Workspace>()),
+      rng(std::make_unique<RandomGenerator>(params.random_seed)) {
     initialize();
 }
 
 DOGM::~DOGM() = default;
 
+void DOGM::applyPendingDecay() const {
+    if (sparseCells() && decayed_time < grid_time) {
+        kernel::applyPendingDecay(grid_cells, grid_moments, grid_time, params.freespace_discount);
+        decayed_time = grid_time;
+    }
+}
+
+const std::vector<GridCell>& DOGM::getGridCells() const {
+    applyPendingDecay();
+    return grid_cells;
+}
+
+const std::vector<GridCellMoments>& DOGM::getGridMoments() const {
+    applyPendingDecay();
+    return grid_moments;
+}
+
+int DOGM::getActiveCellCount() const {
+    return sparseCells() ? static_cast<int>(active_cells.list.size()) : grid_cell_count;
+}
+
 void DOGM::initialize() {
     grid_cells.resize(grid_cell_count);
+    grid_moments.resize(grid_cell_count);
     meas_cells.resize(grid_cell_count);
     
     particles.resize(params.particle_count);
-    particles_next.resize(params.particle_count);
+    if (params.compact_particle_state) {
+        compact_particles.resize(params.particle_count);
+    } else {
+        particles_next.resize(params.particle_count);
+    }
     birth_particles.resize(params.new_born_particle_count);
     
     weight_array.resize(params.particle_count);
     birth_weight_array.resize(params.new_born_particle_count);
     born_masses_array.resize(grid_cell_count);
+    active_cells.resize(grid_cell_count);
     
-    kernel::initGridCells(grid_cells);
-    kernel::initParticles(particles, *rng, params.init_max_velocity, grid_size, params.resolution);
+    latency_histogram.resize(std::max(params.stats_histogram_window, 0));
+    
+    // adaptive 모드에서 파티클 수가 바뀌어도 재할당하지 않도록 최대 용량을 미리 잡는다
+    if (params.adaptive_particle_count && params.reserve_max_particles) {
+        const size_t capacity = kernel::maxParticleCount(params);
+        const size_t birth_capacity = kernel::maxBirthParticleCount(params);
+        particles.reserve(capacity);
+        if (params.compact_particle_state) {
+            compact_particles.reserve(capacity);
+        } else {
+            particles_next.reserve(capacity);
+        }
+        weight_array.reserve(capacity);
+        birth_particles.reserve(birth_capacity);
+        birth_weight_array.reserve(birth_capacity);
+    }
+    kernel::reserveWorkspace(*workspace, params, grid_size, grid_cell_count, omp_get_max_threads());
+    
+    kernel::initGridCells(grid_cells, meas_cells);
+    rng->setFrame(frame_index);
+    if (params.compact_particle_state) {
+        kernel::initParticles(compact_particles, *rng, params.init_max_velocity, window);
+    } else {
+        kernel::initParticles(particles, *rng, params.init_max_velocity, window);
+    }
 }
 
 void DOGM::updateGrid(const SensorFrame& frame, float dt) {
+    updateGrid(SensorFrameView(frame), dt);
+}
+
+void DOGM::updateGrid(const SensorFrameView& frame, float dt) {
+    beginFrame(frame);
+    measurementStage(frame);
+    predictionStage(dt);
+    cellStage(dt);
+    resamplingStage();
+}
+
+void DOGM::beginFrame(const SensorFrameView& frame) {
     // 프레임에서 ego_pose와 ego_yaw를 클래스 멤버 변수로 업데이트
     this->ego_pose = frame.ego_pose;
     this->ego_yaw = frame.ego_yaw;
 
+    // 프레임마다 새 난수 스트림 사용 (결과는 스레드 수와 무관)
+    rng->setFrame(++frame_index);
+
+#if DOGM_ENABLE_STATS
+    stats = DOGMStats();
+    stats.frame = frame_index;
+    frame_start = std::chrono::steady_clock::now();
+#endif
+
+    egoMotionCompensation();
+}
+
+void DOGM::measurementStage(const SensorFrameView& frame) {
     updateMeasurementGrid(frame);
-    
-    // TODO: Implement ego motion compensation based on frame.ego_pose
-    
+    collectMeasurementStats();
+}
+
+void DOGM::predictionStage(float dt) {
     particlePrediction(dt);
+    collectPredictionStats();
     particleAssignment();
-    // gridCellOccupancyUpdate의 인자에서 particles 제거
-    gridCellOccupancyUpdate(dt);
-    updatePersistentParticles();
-    initializeNewParticles();
-    statisticalMoments();
+}
+
+void DOGM::cellStage(float dt) {
+    grid_time += dt;
+    if (params.fused_cell_update) {
+        fusedCellUpdate(dt);
+        initializeNewParticles();
+    } else {
+        // gridCellOccupancyUpdate의 인자에서 particles 제거
+        gridCellOccupancyUpdate(dt);
+        updatePersistentParticles();
+        initializeNewParticles();
+        statisticalMoments();
+    }
+}
+
+void DOGM::resamplingStage() {
+    collectResamplingStats();
     resampling();
     
-    std::swap(particles, particles_next);
+    // compact 모드는 resampling이 compact_particles에 직접 쓴다
+    if (!params.compact_particle_state) std::swap(particles, particles_next);
+
+#if DOGM_ENABLE_STATS
+    auto frame_end = std::chrono::steady_clock::now();
+    stats.total_ms = std::chrono::duration<double, std::milli>(frame_end - frame_start).count();
+    latency_histogram.add(stats);
+#endif
 }
 
-void DOGM::updateMeasurementGrid(const SensorFrame& frame) {
+// 창을 ego 위치 중심으로 셀 단위 이동한다. 셀 데이터는 복사하지 않고 ring buffer offset만 바꾸며,
+// 새로 들어온 가장자리 셀만 초기화하고 파티클은 같은 셀 수만큼 반대로 평행 이동한다.
+// 창 원점은 매 프레임 절대 pose에서 다시 계산하므로 셀보다 작은 이동은 버려지지 않고
+// 다음 프레임들에 누적되어, 누적량이 한 셀을 넘는 프레임에 이동이 일어난다 (drift 없음).
+void DOGM::egoMotionCompensation() {
+    DOGM_STAGE_TIMER(stats, Stage::EgoMotion);
+    if (!params.follow_ego) return;
+
+    const GridWindow target = windowFor(ego_pose);
+
+    if (first_update) {
+        // 첫 프레임은 이동이 아니라 창의 초기 배치. 파티클은 이미 로컬 좌표로 초기화되어 있다.
+        window = target;
+        first_update = false;
+        return;
+    }
+
+    const int shift_x = target.origin_x - window.origin_x;
+    const int shift_y = target.origin_y - window.origin_y;
+    if (shift_x == 0 && shift_y == 0) return;
+
+    window = target;
+    kernel::clearEnteringCells(grid_cells, grid_moments, window, shift_x, shift_y);
+    if (params.compact_particle_state) {
+        kernel::shiftParticles(compact_particles, -shift_x, -shift_y);
+    } else {
+        kernel::shiftParticles(particles, static_cast<float>(-shift_x), static_cast<float>(-shift_y));
+    }
+}
+
+// pose에서의 창 위치. 창은 절대 pose만으로 정해지므로(ring offset = origin mod grid_size)
+// 현재 창 상태를 읽지 않고 다음 프레임의 창을 미리 계산할 수 있다.
+GridWindow DOGM::windowFor(const Vec2& pose) const {
+    GridWindow target(grid_size, params.resolution, params.grid_layout);
+    if (params.follow_ego) {
+        target.moveTo(static_cast<int>(std::floor(pose.x() / params.resolution)) - grid_size / 2,
+                      static_cast<int>(std::floor(pose.y() / params.resolution)) - grid_size / 2);
+    }
+    return target;
+}
+
+void DOGM::buildPendingMeasurementGrid(const SensorFrameView& frame) {
+    auto start = std::chrono::steady_clock::now();
+    if (pending_meas_cells.size() != static_cast<size_t>(grid_cell_count)) {
+        pending_meas_cells.resize(grid_cell_count);
+    }
+    const GridWindow pending_window = windowFor(frame.ego_pose);
+    kernel::fuseAndCreateMeasurementGrid(pending_meas_cells, frame, pending_window, frame.ego_pose,
+                                         frame.ego_yaw, workspace->rays, workspace->radar, pending_measured_cells);
+    kernel::clearMeasurements(pending_meas_cells, pending_measured_cells, pending_window,
+                              kernel::innerRegion(pending_window, frame.ego_pose, params.inner_size));
+    pending_measurement_ms =
+        std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+void DOGM::swapInPendingMeasurementGrid() {
+    std::swap(meas_cells, pending_meas_cells);
+    std::swap(measured_cells, pending_measured_cells);
+#if DOGM_ENABLE_STATS
+    stats.stage_ms[static_cast<int>(Stage::MeasurementGrid)] = pending_measurement_ms;
+#endif
+    collectMeasurementStats();
+}
+
+void DOGM::updateMeasurementGrid(const SensorFrameView& frame) {
+    DOGM_STAGE_TIMER(stats, Stage::MeasurementGrid);
     // fuseAndCreateMeasurementGrid 함수를 호출하도록 변경합니다.
-    kernel::fuseAndCreateMeasurementGrid(meas_cells, frame, grid_size, params.resolution, ego_pose, ego_yaw);
+    kernel::fuseAndCreateMeasurementGrid(meas_cells, frame, window, ego_pose, ego_yaw, workspace->rays,
+                                         workspace->radar, measured_cells);
+    kernel::clearMeasurements(meas_cells, measured_cells, window,
+                              kernel::innerRegion(window, ego_pose, params.inner_size));
 }
 
 // 나머지 함수들은 기존과 동일합니다.
 void DOGM::particlePrediction(float dt) {
-    kernel::predict(particles, *rng, params, grid_size, params.resolution, dt);
+    DOGM_STAGE_TIMER(stats, Stage::Prediction);
+    if (params.compact_particle_state) {
+        kernel::predict(compact_particles, *rng, params, window, dt);
+    } else {
+        kernel::predict(particles, *rng, params, window, dt);
+    }
 }
 
 void DOGM::particleAssignment() {
-    kernel::particleToGrid(particles, grid_cells, weight_array);
+    DOGM_STAGE_TIMER(stats, Stage::Assignment);
+    if (params.compact_particle_state) {
+        // 복원한 float 파티클이 정렬된 채로 particles에 들어간다
+        resizeParticleBuffer(weight_array, compact_particles.size());
+        kernel::particleToGrid(compact_particles, particles, grid_cells, weight_array, workspace->cell_histogram,
+                               workspace->compact_cells, particle_cells, window, params.persistence_prob);
+    } else {
+        // particles_next는 resampling 전까지 비어 있으므로 정렬 대상 버퍼로 사용
+        resizeParticleBuffer(weight_array, particles.size());
+        kernel::particleToGrid(particles, particles_next, grid_cells, weight_array, workspace->cell_histogram,
+                               particle_cells);
+        std::swap(particles, particles_next);
+    }
+    // 더 세밀한 그리드가 담당하는 안쪽 영역의 파티클은 버린다
+    kernel::clearParticleWeights(particles, weight_array, grid_cells, window,
+                                 kernel::innerRegion(window, ego_pose, params.inner_size));
 }
 
 void DOGM::gridCellOccupancyUpdate(float dt) {
+    DOGM_STAGE_TIMER(stats, Stage::OccupancyUpdate);
     // updateOccupancy 함수 시그니처 변경에 따라 particles 인자 제거
     kernel::updateOccupancy(grid_cells, weight_array, meas_cells, born_masses_array, params, dt);
 }
 
+// occupancy, persistent, moments 세 스테이지를 한 번에 수행. 시간은 OccupancyUpdate에 기록된다.
+// sparse_cells면 파티클 또는 측정이 있는 셀만 갱신한다.
+void DOGM::fusedCellUpdate(float dt) {
+    DOGM_STAGE_TIMER(stats, Stage::OccupancyUpdate);
+    if (sparseCells()) {
+        active_cells.assignUnion(measured_cells, particle_cells);
+        kernel::CellClock clock;
+        clock.previous = grid_time - dt;
+        clock.current = grid_time;
+        kernel::updateCellsFusedSparse(grid_cells, grid_moments, active_cells, particles, weight_array, meas_cells,
+                                       born_masses_array, params, dt, clock);
+        return;
+    }
+    kernel::updateCellsFused(grid_cells, grid_moments, particles, weight_array, meas_cells, born_masses_array,
+                             params, dt);
+}
+
 void DOGM::updatePersistentParticles() {
-    // ego_pose를 넘겨주도록 수정
-    kernel::updatePersistent(particles, meas_cells, grid_cells, weight_array, ego_pose);
+    DOGM_STAGE_TIMER(stats, Stage::PersistentUpdate);
+    kernel::updatePersistent(particles, meas_cells, grid_cells, weight_array);
 }
 
 void DOGM::initializeNewParticles() {
-    kernel::initNewParticles(birth_particles, grid_cells, meas_cells, born_masses_array, *rng, params, grid_size, params.resolution);
+    DOGM_STAGE_TIMER(stats, Stage::NewBornParticles);
+    if (params.adaptive_particle_count) {
+        // 신생 파티클 수는 현재 파티클 수에 비례
+        size_t birth_count = std::max<size_t>(1, static_cast<size_t>(std::lround(
+            static_cast<double>(particles.size()) * params.new_born_particle_count / params.particle_count)));
+        resizeParticleBuffer(birth_particles, birth_count);
+        resizeParticleBuffer(birth_weight_array, birth_count);
+    }
+    if (sparseCells()) {
+        kernel::initNewParticles(birth_particles, active_cells, meas_cells, born_masses_array, *rng, params, window,
+                                 workspace->birth);
+    } else {
+        kernel::initNewParticles(birth_particles, meas_cells, born_masses_array, *rng, params, window,
+                                 workspace->birth);
+    }
+    // resampling에서 persistent 파티클과 함께 사용되는 신생 파티클 가중치
+    std::copy(birth_particles.weight.begin(), birth_particles.weight.end(), birth_weight_array.begin());
 }
 
 void DOGM::statisticalMoments() {
-    kernel::computeStatisticalMoments(particles, grid_cells, weight_array);
+    DOGM_STAGE_TIMER(stats, Stage::StatisticalMoments);
+    kernel::computeStatisticalMoments(particles, grid_cells, grid_moments, weight_array);
 }
 
 void DOGM::resampling() {
-    kernel::resample(particles, particles_next, birth_particles, weight_array, birth_weight_array, *rng);
+    DOGM_STAGE_TIMER(stats, Stage::Resampling);
+    if (params.adaptive_particle_count) {
+        adaptParticleCount();
+    }
+    if (params.compact_particle_state) {
+        kernel::resample(particles, compact_particles, birth_particles, weight_array, birth_weight_array, *rng,
+                         params, window, workspace->resampling);
+        return;
+    }
+    kernel::resample(particles, particles_next, birth_particles, weight_array, birth_weight_array, *rng, params,
+                     window, workspace->resampling);
+}
+
+// resampling 결과 크기(particles_next)를 다음 프레임의 파티클 수로 조정한다.
+void DOGM::adaptParticleCount() {
+    kernel::ParticleCountInputs inputs;
+    inputs.current_count = static_cast<int>(particles.size());
+    inputs.joint_count = static_cast<int>(weight_array.size() + birth_weight_array.size());
+
+    switch (params.particle_count_criterion) {
+    case ParticleCountCriterion::EffectiveSampleSize:
+        inputs.effective_sample_size = jointEffectiveSampleSize();
+        break;
+    case ParticleCountCriterion::OccupiedCells: {
+        // sparse면 비활성 셀의 occ_mass는 0이므로 이번 프레임에 갱신한 셀만 센다
+        int occupied = 0;
+        if (sparseCells()) {
+            for (int i : active_cells.list) {
+                occupied += grid_cells[i].occ_mass > params.occupied_mass_threshold;
+            }
+        } else {
+            #pragma omp parallel for reduction(+:occupied)
+            for (int i = 0; i < grid_cell_count; ++i) {
+                occupied += grid_cells[i].occ_mass > params.occupied_mass_threshold;
+            }
+        }
+        inputs.occupied_cells = occupied;
+        break;
+    }
+    case ParticleCountCriterion::KLD:
+        inputs.support_cells = static_cast<int>(particle_cells.list.size());
+        break;
+    }
+
+    int next_count = kernel::chooseParticleCount(params, inputs);
+    if (params.compact_particle_state) {
+        resizeParticleBuffer(compact_particles, next_count);
+    } else {
+        resizeParticleBuffer(particles_next, next_count);
+    }
+}
+
+// reserve_max_particles면 용량이 이미 최대이므로 크기만 바꾼다
+void DOGM::resizeParticleBuffer(ParticlesSoA& buffer, size_t count) {
+    if (params.reserve_max_particles) {
+        buffer.resize(count);
+    } else {
+        buffer.resizeWithHysteresis(count, params.capacity_hysteresis);
+    }
+}
+
+void DOGM::resizeParticleBuffer(CompactParticlesSoA& buffer, size_t count) {
+    if (params.reserve_max_particles) {
+        buffer.resize(count);
+    } else {
+        buffer.resizeWithHysteresis(count, params.capacity_hysteresis);
+    }
+}
+
+void DOGM::resizeParticleBuffer(std::vector<float>& buffer, size_t count) {
+    if (params.reserve_max_particles) {
+        buffer.resize(count);
+    } else {
+        resizeWithHysteresis(buffer, count, params.capacity_hysteresis);
+    }
+}
+
+// ESS = (sum w)^2 / sum w^2, resampling에 들어가는 joint weight 기준
+float DOGM::jointEffectiveSampleSize() const {
+    // 고정 블록 순서로 더해 스레드 수가 달라도 같은 값 (adaptive particle count가 이 값으로 정해진다)
+    const float* weights = weight_array.data();
+    double sum = blockedSum(weight_array.size(), [weights](size_t i) { return static_cast<double>(weights[i]); });
+    double sum_sq = blockedSum(weight_array.size(), [weights](size_t i) {
+        const double w = weights[i];
+        return w * w;
+    });
+    for (float w : birth_weight_array) {
+        sum += static_cast<double>(w);
+        sum_sq += static_cast<double>(w) * w;
+    }
+    return sum_sq > 0.0 ? static_cast<float>(sum * sum / sum_sq) : 0.0f;
+}
+
+// 계측용 카운터. 스테이지 타이머에는 포함되지 않으며, DOGM_ENABLE_STATS=0이면 비어 있다.
+void DOGM::collectMeasurementStats() {
+#if DOGM_ENABLE_STATS
+    // 측정이 없는 셀은 세 값이 모두 0이다
+    int occupied = 0, free = 0, radar = 0;
+    for (int i : measured_cells.list) {
+        occupied += meas_cells[i].occ_mass > 0.0f;
+        free += meas_cells[i].free_mass > 0.0f;
+        radar += meas_cells[i].velocity_confidence > 0.0f;
+    }
+    stats.meas_occupied_cells = occupied;
+    stats.meas_free_cells = free;
+    stats.meas_radar_cells = radar;
+#endif
+}
+
+void DOGM::collectPredictionStats() {
+#if DOGM_ENABLE_STATS
+    int alive = 0, out_of_bounds = 0;
+    if (params.compact_particle_state) {
+        // 가중치는 particleToGrid에서 갱신되므로 창 밖이 아니고 0이 아닌 파티클을 센다
+        const int count = static_cast<int>(compact_particles.size());
+        const int16_t* cell_x = compact_particles.cell_x.data();
+        const int16_t* cell_y = compact_particles.cell_y.data();
+        const int16_t* log_weight = compact_particles.log_weight.data();
+        #pragma omp parallel for reduction(+:alive, out_of_bounds)
+        for (int i = 0; i < count; ++i) {
+            const bool outside = cell_x[i] < 0 || cell_x[i] >= grid_size || cell_y[i] < 0 || cell_y[i] >= grid_size;
+            out_of_bounds += outside;
+            alive += !outside && log_weight[i] != kCompactZeroWeight;
+        }
+        stats.particles_alive = alive;
+        stats.particles_out_of_bounds = out_of_bounds;
+        return;
+    }
+    const int count = static_cast<int>(particles.size());
+    #pragma omp parallel for reduction(+:alive, out_of_bounds)
+    for (int i = 0; i < count; ++i) {
+        const float x = particles.x[i];
+        const float y = particles.y[i];
+        out_of_bounds += x < 0 || x >= grid_size || y < 0 || y >= grid_size;
+        alive += particles.weight[i] > 0.0f;
+    }
+    stats.particles_alive = alive;
+    stats.particles_out_of_bounds = out_of_bounds;
+#endif
+}
+
+void DOGM::collectResamplingStats() {
+#if DOGM_ENABLE_STATS
+    int born = 0;
+    for (size_t i = 0; i < birth_particles.size(); ++i) {
+        born += birth_particles.weight[i] > 0.0f;
+    }
+    stats.particles_born = born;
+    stats.effective_sample_size = jointEffectiveSampleSize();
+#endif
 }
 
-} // namespace dogm
\ No newline at end of file
+} // namespace dogm
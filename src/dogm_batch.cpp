@@ -0,0 +1,79 @@
+#include "dogm/dogm_batch.h"
+#include <omp.h>
+
+namespace dogm {
+
+namespace {
+
+// 그리드 하나의 단계 완료 표시. task depend 절의 주소로만 쓰인다.
+enum StageToken : int {
+    kBeginToken = 0,
+    kMeasurementToken,
+    kPredictionToken,
+    kStageTokens
+};
+
+} // namespace
+
+DOGMBatch::DOGMBatch(const std::vector<DOGM::Params>& params) {
+    for (const auto& p : params) {
+        addGrid(p);
+    }
+}
+
+size_t DOGMBatch::addGrid(const DOGM::Params& params) {
+    grids.push_back(std::make_unique<DOGM>(params));
+    stage_tokens.resize(grids.size() * kStageTokens);
+    return grids.size() - 1;
+}
+
+void DOGMBatch::updateGrids(const std::vector<SensorFrameView>& frames, float dt) {
+    run([&frames](int i) { return frames[i]; }, dt);
+}
+
+void DOGMBatch::updateGrids(const SensorFrameView& frame, float dt) {
+    run([&frame](int) { return frame; }, dt);
+}
+
+// 그리드마다 beginFrame -> { measurement, prediction } -> cells + resampling 순서의 task를 만든다.
+// 서로 다른 그리드의 task 사이에는 의존성이 없으므로 팀의 스레드가 준비된 task를 가져가 실행한다.
+template<typename FrameAt>
+void DOGMBatch::run(FrameAt frame_at, float dt) {
+    const int count = static_cast<int>(grids.size());
+    if (count == 0) return;
+    if (count == 1) {
+        grids[0]->updateGrid(frame_at(0), dt);
+        return;
+    }
+
+    // task 안의 커널 parallel 영역이 새 스레드 팀을 열지 않도록 중첩을 한 단계로 제한
+    const int max_active_levels = omp_get_max_active_levels();
+    omp_set_max_active_levels(1);
+
+    #pragma omp parallel
+    #pragma omp single
+    for (int i = 0; i < count; ++i) {
+        DOGM* grid = grids[i].get();
+        const SensorFrameView frame = frame_at(i);
+        char* token = &stage_tokens[static_cast<size_t>(i) * kStageTokens];
+
+        #pragma omp task depend(out: token[kBeginToken])
+        grid->beginFrame(frame);
+
+        #pragma omp task depend(in: token[kBeginToken]) depend(out: token[kMeasurementToken])
+        grid->measurementStage(frame);
+
+        #pragma omp task depend(in: token[kBeginToken]) depend(out: token[kPredictionToken])
+        grid->predictionStage(dt);
+
+        #pragma omp task depend(in: token[kMeasurementToken], token[kPredictionToken])
+        {
+            grid->cellStage(dt);
+            grid->resamplingStage();
+        }
+    }
+
+    omp_set_max_active_levels(max_active_levels);
+}
+
+} // namespace dogm
@@ -0,0 +1,122 @@
+#include "dogm/dogm_multires.h"
+#include <algorithm>
+#include <cmath>
+
+namespace dogm {
+
+namespace {
+
+// 출력 셀 하나를 평균할 때 축당 최대 샘플 수
+constexpr int kMaxSubsamples = 16;
+
+} // namespace
+
+DOGMMultiRes::DOGMMultiRes(const Params& params) {
+    for (size_t i = 0; i < params.levels.size(); ++i) {
+        const Level& level = params.levels[i];
+        DOGM::Params grid = params.grid;
+        grid.size = level.size;
+        grid.resolution = level.resolution;
+        if (level.particle_count > 0) grid.particle_count = level.particle_count;
+        if (level.new_born_particle_count > 0) grid.new_born_particle_count = level.new_born_particle_count;
+        grid.follow_ego = true;
+        grid.random_seed = params.grid.random_seed + static_cast<unsigned int>(i);
+        // 안쪽 level의 창은 셀 단위로 ego를 따라가므로 ego 중심 size - 2 * resolution 정사각형은 항상 덮는다
+        const float inner = (i > 0) ? params.levels[i - 1].size - 2.0f * params.levels[i - 1].resolution : 0.0f;
+        grid.inner_size = std::max(inner, 0.0f);
+        batch.addGrid(grid);
+    }
+}
+
+void DOGMMultiRes::updateGrid(const SensorFrame& frame, float dt) {
+    updateGrid(SensorFrameView(frame), dt);
+}
+
+void DOGMMultiRes::updateGrid(const SensorFrameView& frame, float dt) {
+    center = frame.ego_pose;
+    batch.updateGrids(frame, dt);
+}
+
+int DOGMMultiRes::getCellCount() const {
+    int cells = 0;
+    for (int l = 0; l < getLevelCount(); ++l) {
+        cells += getLevel(l).getGridSize() * getLevel(l).getGridSize();
+    }
+    return cells;
+}
+
+int DOGMMultiRes::getActiveCellCount() const {
+    int cells = 0;
+    for (int l = 0; l < getLevelCount(); ++l) {
+        cells += getLevel(l).getActiveCellCount();
+    }
+    return cells;
+}
+
+void DOGMMultiRes::sampleGrid(float resolution, float size, std::vector<GridSample>& samples) const {
+    const int n = std::max(static_cast<int>(size / resolution), 0);
+    samples.assign(static_cast<size_t>(n) * n, GridSample());
+    if (n == 0) return;
+
+    // sparse 모드의 밀린 decay는 여기서 level마다 한 번 적용된다
+    const int level_count = getLevelCount();
+    std::vector<const GridCell*> cells(level_count);
+    std::vector<const GridCellMoments*> moments(level_count);
+    for (int l = 0; l < level_count; ++l) {
+        cells[l] = getLevel(l).getGridCells().data();
+        moments[l] = getLevel(l).getGridMoments().data();
+    }
+
+    // 월드 점 (px, py)를 덮는 가장 세밀한 level과 그 셀의 저장 위치. 어느 창에도 없으면 level -1.
+    auto locate = [&](float px, float py, int& level) {
+        for (int l = 0; l < level_count; ++l) {
+            const GridWindow& window = getLevel(l).getGridWindow();
+            const int x = static_cast<int>(std::floor(px / window.resolution)) - window.origin_x;
+            const int y = static_cast<int>(std::floor(py / window.resolution)) - window.origin_y;
+            if (x >= 0 && x < window.grid_size && y >= 0 && y < window.grid_size) {
+                level = l;
+                return window.physicalIndex(x, y);
+            }
+        }
+        level = -1;
+        return -1;
+    };
+
+    const float x0 = center.x() - 0.5f * size;
+    const float y0 = center.y() - 0.5f * size;
+
+    #pragma omp parallel for schedule(static)
+    for (int oy = 0; oy < n; ++oy) {
+        for (int ox = 0; ox < n; ++ox) {
+            GridSample& sample = samples[static_cast<size_t>(oy) * n + ox];
+            locate(x0 + (ox + 0.5f) * resolution, y0 + (oy + 0.5f) * resolution, sample.level);
+            if (sample.level < 0) continue;
+
+            // 셀 중심 level의 해상도 기준으로 출력 셀 안을 sub x sub 점으로 나눠 평균한다
+            const float source_resolution = getLevel(sample.level).getGridWindow().resolution;
+            const int sub = clamp(static_cast<int>(std::lround(resolution / source_resolution)), 1, kMaxSubsamples);
+            const float step = resolution / sub;
+            float occ = 0.0f, free = 0.0f, vx = 0.0f, vy = 0.0f;
+            for (int sy = 0; sy < sub; ++sy) {
+                for (int sx = 0; sx < sub; ++sx) {
+                    int level;
+                    const int idx = locate(x0 + ox * resolution + (sx + 0.5f) * step,
+                                           y0 + oy * resolution + (sy + 0.5f) * step, level);
+                    if (idx < 0) continue;  // 가장 바깥 창 밖은 unknown
+                    const GridCell& cell = cells[level][idx];
+                    occ += cell.occ_mass;
+                    free += cell.free_mass;
+                    vx += cell.occ_mass * moments[level][idx].mean_x_vel;
+                    vy += cell.occ_mass * moments[level][idx].mean_y_vel;
+                }
+            }
+            const float inv_count = 1.0f / (sub * sub);
+            sample.occ_mass = occ * inv_count;
+            sample.free_mass = free * inv_count;
+            sample.mean_x_vel = occ > 0.0f ? vx / occ : 0.0f;
+            sample.mean_y_vel = occ > 0.0f ? vy / occ : 0.0f;
+        }
+    }
+}
+
+} // namespace dogm
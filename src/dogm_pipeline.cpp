@@ -0,0 +1,122 @@
+#include "dogm/dogm_pipeline.h"
+#include <omp.h>
+#include <algorithm>
+
+namespace dogm {
+
+DOGMPipeline::DOGMPipeline(const DOGM::Params& params, int measurement_threads)
+    : dogm(params), measurement_threads(std::max(measurement_threads, 1)) {
+    measurement_thread = std::thread(&DOGMPipeline::measurementLoop, this);
+    update_thread = std::thread(&DOGMPipeline::updateLoop, this);
+}
+
+DOGMPipeline::~DOGMPipeline() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    changed.notify_all();
+    update_thread.join();
+    measurement_thread.join();
+}
+
+std::future<void> DOGMPipeline::submitFrame(const SensorFrameView& frame, float dt) {
+    std::future<void> result;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        jobs.emplace_back();
+        jobs.back().frame = frame;
+        jobs.back().dt = dt;
+        result = jobs.back().done.get_future();
+        ++submitted;
+    }
+    changed.notify_all();
+    return result;
+}
+
+void DOGMPipeline::waitIdle() {
+    std::unique_lock<std::mutex> lock(mutex);
+    changed.wait(lock, [this] { return completed == submitted; });
+}
+
+// 측정 그리드는 프레임 순서대로, back 버퍼가 비었을 때(직전 것을 갱신 스레드가 가져간 뒤)만 만든다.
+void DOGMPipeline::measurementLoop() {
+    omp_set_num_threads(measurement_threads);
+
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        changed.wait(lock, [this] {
+            return (measured < submitted && measured == swapped) || (stopping && measured == submitted);
+        });
+        if (measured == submitted) return;
+
+        Job& current = job(measured);
+        lock.unlock();
+        try {
+            dogm.buildPendingMeasurementGrid(current.frame);
+        } catch (...) {
+            current.measurement_error = std::current_exception();
+        }
+        lock.lock();
+        ++measured;
+        changed.notify_all();
+    }
+}
+
+// 프레임마다 prediction까지 진행한 뒤 측정 그리드를 기다려 가져오고, back 버퍼를 측정 스레드에 돌려준다.
+void DOGMPipeline::updateLoop() {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        changed.wait(lock, [this] { return completed < submitted || stopping; });
+        if (completed == submitted) return;
+
+        Job& current = jobs.front();
+        lock.unlock();
+
+        std::exception_ptr error;
+        try {
+            dogm.beginFrame(current.frame);
+            dogm.predictionStage(current.dt);
+        } catch (...) {
+            error = std::current_exception();
+        }
+
+        lock.lock();
+        changed.wait(lock, [this] { return measured > swapped; });
+        if (!error) error = current.measurement_error;
+        lock.unlock();
+
+        try {
+            if (!error) dogm.swapInPendingMeasurementGrid();
+        } catch (...) {
+            error = std::current_exception();
+        }
+
+        lock.lock();
+        ++swapped;
+        changed.notify_all();
+        lock.unlock();
+
+        try {
+            if (!error) {
+                dogm.cellStage(current.dt);
+                dogm.resamplingStage();
+                if (frame_callback) frame_callback(dogm);
+            }
+        } catch (...) {
+            error = std::current_exception();
+        }
+        if (error) {
+            current.done.set_exception(error);
+        } else {
+            current.done.set_value();
+        }
+
+        lock.lock();
+        jobs.pop_front();
+        ++completed;
+        changed.notify_all();
+    }
+}
+
+} // namespace dogm
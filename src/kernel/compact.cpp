@@ -0,0 +1,49 @@
+#include "dogm/kernel/compact.h"
+#include "dogm/particle_codec.h"
+
+namespace dogm {
+namespace kernel {
+
+void encodeParticles(const ParticlesSoA& particles, CompactParticlesSoA& compact) {
+    const int count = static_cast<int>(particles.size());
+    compact.resize(particles.size());
+
+    #pragma omp parallel for simd
+    for (int i = 0; i < count; ++i) {
+        encodePosition(particles.x[i], compact.cell_x[i], compact.offset_x[i]);
+        encodePosition(particles.y[i], compact.cell_y[i], compact.offset_y[i]);
+        compact.vx[i] = floatToHalf(particles.vx[i]);
+        compact.vy[i] = floatToHalf(particles.vy[i]);
+    }
+
+    // log2는 벡터화되지 않으므로 따로 돈다
+    #pragma omp parallel for
+    for (int i = 0; i < count; ++i) {
+        compact.log_weight[i] = encodeLogWeight(particles.weight[i]);
+    }
+}
+
+void decodeParticles(const CompactParticlesSoA& compact, ParticlesSoA& particles, const GridWindow& window) {
+    const int count = static_cast<int>(compact.size());
+    const int grid_size = window.grid_size;
+    particles.resize(compact.size());
+
+    #pragma omp parallel for simd
+    for (int i = 0; i < count; ++i) {
+        particles.x[i] = decodePosition(compact.cell_x[i], compact.offset_x[i]);
+        particles.y[i] = decodePosition(compact.cell_y[i], compact.offset_y[i]);
+        particles.vx[i] = halfToFloat(compact.vx[i]);
+        particles.vy[i] = halfToFloat(compact.vy[i]);
+        particles.weight[i] = decodeLogWeight(compact.log_weight[i]);
+    }
+
+    #pragma omp parallel for
+    for (int i = 0; i < count; ++i) {
+        particles.grid_cell_idx[i] = window.physicalIndex(clamp<int>(compact.cell_x[i], 0, grid_size - 1),
+                                                          clamp<int>(compact.cell_y[i], 0, grid_size - 1));
+        particles.associated[i] = false;
+    }
+}
+
+} // namespace kernel
+} // namespace dogm
@@ -0,0 +1,69 @@
+#include "dogm/kernel/ego_motion.h"
+#include <cstdlib>
+
+namespace dogm {
+namespace kernel {
+
+void clearEnteringCells(std::vector<GridCell>& grid_cells, std::vector<GridCellMoments>& grid_moments,
+                        const GridWindow& window, int shift_x, int shift_y) {
+    const int grid_size = window.grid_size;
+    auto clear = [&](int idx) {
+        grid_cells[idx] = GridCell();
+        grid_moments[idx] = GridCellMoments();
+    };
+
+    // 한 축이라도 창 크기 이상 이동하면 겹치는 영역이 없다
+    if (std::abs(shift_x) >= grid_size || std::abs(shift_y) >= grid_size) {
+        #pragma omp parallel for
+        for (int i = 0; i < static_cast<int>(grid_cells.size()); ++i) {
+            clear(i);
+        }
+        return;
+    }
+
+    // +x 이동이면 오른쪽 끝 열들이, -x 이동이면 왼쪽 끝 열들이 새로 들어온다 (로컬 좌표)
+    const int col_begin = shift_x > 0 ? grid_size - shift_x : 0;
+    const int col_end = shift_x > 0 ? grid_size : -shift_x;
+    const int row_begin = shift_y > 0 ? grid_size - shift_y : 0;
+    const int row_end = shift_y > 0 ? grid_size : -shift_y;
+
+    #pragma omp parallel for
+    for (int y = 0; y < grid_size; ++y) {
+        if (y >= row_begin && y < row_end) {
+            for (int x = 0; x < grid_size; ++x) {
+                clear(window.physicalIndex(x, y));
+            }
+            continue;
+        }
+        for (int x = col_begin; x < col_end; ++x) {
+            clear(window.physicalIndex(x, y));
+        }
+    }
+}
+
+void shiftParticles(ParticlesSoA& particles, float dx, float dy) {
+    const int count = static_cast<int>(particles.size());
+    float* x = particles.x.data();
+    float* y = particles.y.data();
+
+    #pragma omp parallel for simd
+    for (int i = 0; i < count; ++i) {
+        x[i] += dx;
+        y[i] += dy;
+    }
+}
+
+void shiftParticles(CompactParticlesSoA& particles, int dx, int dy) {
+    const int count = static_cast<int>(particles.size());
+    int16_t* cell_x = particles.cell_x.data();
+    int16_t* cell_y = particles.cell_y.data();
+
+    #pragma omp parallel for simd
+    for (int i = 0; i < count; ++i) {
+        cell_x[i] = static_cast<int16_t>(clamp(cell_x[i] + dx, -32768, 32767));
+        cell_y[i] = static_cast<int16_t>(clamp(cell_y[i] + dy, -32768, 32767));
+    }
+}
+
+} // namespace kernel
+} // namespace dogm
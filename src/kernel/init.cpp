@@ -1,4 +1,5 @@
 #include "dogm/kernel/init.h"
+#include "dogm/particle_codec.h"
 #include <numeric>
 
 namespace dogm {
@@ -13,29 +14,62 @@ void initGridCells(std::vector<GridCell>& grid_cells, std::vector<MeasurementCel
     }
 }
 
-void initParticles(ParticlesSoA& particles, RandomGenerator& rng, float max_velocity, int grid_size) {
-    float new_weight = 1.0f / particles.size();
+namespace {
+
+// 창 전체에 균일한 위치와 [-max_velocity, max_velocity] 속도를 뽑아 store(i, x, y, vx, vy)에 넘긴다
+template<typename Store>
+void initParticlesImpl(size_t count, const RandomGenerator& rng, float max_velocity, const GridWindow& window,
+                       Store store) {
+    const int grid_size = window.grid_size;
 
     #pragma omp parallel for
-    for (size_t i = 0; i < particles.size(); ++i) {
-        float x = rng.uniform(0.0f, grid_size - 1.0f);
-        float y = rng.uniform(0.0f, grid_size - 1.0f);
-        float vx = rng.uniform(-max_velocity, max_velocity);
-        float vy = rng.uniform(-max_velocity, max_velocity);
-        
-        particles.state[i] = Vec4(x, y, vx, vy);
-        particles.weight[i] = new_weight;
-        particles.grid_cell_idx[i] = static_cast<int>(y) * grid_size + static_cast<int>(x);
-        particles.associated[i] = false;
+    for (size_t i = 0; i < count; ++i) {
+        float u[4];
+        rng.uniform4(RandomStream::InitParticles, static_cast<uint32_t>(i), u);
+        float x = u[0] * (grid_size - 1.0f);
+        float y = u[1] * (grid_size - 1.0f);
+        float vx = -max_velocity + 2.0f * max_velocity * u[2];
+        float vy = -max_velocity + 2.0f * max_velocity * u[3];
+        store(i, x, y, vx, vy);
     }
 }
 
-void initNewParticles(ParticlesSoA& birth_particles, const std::vector<GridCell>& grid_cells,
-                      const std::vector<MeasurementCell>& meas_cells,
-                      const std::vector<float>& born_masses_array, RandomGenerator& rng,
-                      const DOGM::Params& params, int grid_size) {
+} // namespace
+
+void initParticles(ParticlesSoA& particles, const RandomGenerator& rng, float max_velocity, const GridWindow& window) {
+    float new_weight = 1.0f / particles.size();
+    initParticlesImpl(particles.size(), rng, max_velocity, window,
+        [&](size_t i, float x, float y, float vx, float vy) {
+            particles.setState(i, x, y, vx, vy);
+            particles.weight[i] = new_weight;
+            particles.grid_cell_idx[i] = window.physicalIndex(static_cast<int>(x), static_cast<int>(y));
+            particles.associated[i] = false;
+        });
+}
+
+void initParticles(CompactParticlesSoA& particles, const RandomGenerator& rng, float max_velocity,
+                   const GridWindow& window) {
+    const int16_t log_weight = encodeLogWeight(1.0f / particles.size());
+    initParticlesImpl(particles.size(), rng, max_velocity, window,
+        [&](size_t i, float x, float y, float vx, float vy) {
+            encodePosition(x, particles.cell_x[i], particles.offset_x[i]);
+            encodePosition(y, particles.cell_y[i], particles.offset_y[i]);
+            particles.vx[i] = floatToHalf(vx);
+            particles.vy[i] = floatToHalf(vy);
+            particles.log_weight[i] = log_weight;
+        });
+}
+
+namespace {
 
-    std::vector<float> particle_orders_accum;
+// born_masses_array[k]는 셀 cell_at(k)의 신생 질량
+template<typename CellAt>
+void initNewParticlesImpl(ParticlesSoA& birth_particles, CellAt cell_at,
+                          const std::vector<MeasurementCell>& meas_cells,
+                          const std::vector<float>& born_masses_array, const RandomGenerator& rng,
+                          const DOGM::Params& params, const GridWindow& window, BirthWorkspace& workspace) {
+
+    std::vector<float>& particle_orders_accum = workspace.particle_orders_accum;
     accumulate(born_masses_array, particle_orders_accum);
 
     if (particle_orders_accum.empty() || particle_orders_accum.back() == 0) {
@@ -50,9 +84,10 @@ void initNewParticles(ParticlesSoA& birth_particles, const std::vector<GridCell>
     float v_B = birth_particles.size();
     
     #pragma omp parallel for
-    for (int j = 0; j < grid_cells.size(); ++j) {
-        float start_order = (j == 0) ? 0.0f : particle_orders_accum[j-1];
-        float end_order = particle_orders_accum[j];
+    for (int k = 0; k < static_cast<int>(born_masses_array.size()); ++k) {
+        float start_order = (k == 0) ? 0.0f : particle_orders_accum[k-1];
+        float end_order = particle_orders_accum[k];
+        const int j = cell_at(k);
         
         int start_idx = static_cast<int>(std::ceil(start_order / total_born_mass * v_B));
         int end_idx = static_cast<int>(std::ceil(end_order / total_born_mass * v_B));
@@ -66,29 +101,35 @@ void initNewParticles(ParticlesSoA& birth_particles, const std::vector<GridCell>
         int nu_A = static_cast<int>(roundf(num_new_particles * p_A));
         int nu_UA = num_new_particles - nu_A;
 
-        float w_A = (nu_A > 0) ? (p_A * born_masses_array[j]) / nu_A : 0.0f;
-        float w_UA = (nu_UA > 0) ? ((1.0f - p_A) * born_masses_array[j]) / nu_UA : 0.0f;
+        float w_A = (nu_A > 0) ? (p_A * born_masses_array[k]) / nu_A : 0.0f;
+        float w_UA = (nu_UA > 0) ? ((1.0f - p_A) * born_masses_array[k]) / nu_UA : 0.0f;
+
+        // 셀 j는 ring buffer 저장 위치이므로 창 기준 로컬 좌표로 되돌려 배치한다
+        int local_x, local_y;
+        window.localCoords(j, local_x, local_y);
 
         for (int i = start_idx; i < end_idx; ++i) {
-            float grid_x = j % grid_size + 0.5f;
-            float grid_y = j / grid_size + 0.5f;
+            float grid_x = local_x + 0.5f;
+            float grid_y = local_y + 0.5f;
             
             bool is_associated = (i < start_idx + nu_A);
             
+            float noise[4];
+            rng.normal4(RandomStream::Birth, static_cast<uint32_t>(i), noise);
+
             float vx, vy;
             if (is_associated && meas_cell.velocity_confidence > 0.5f) {
-                // Sample around measured radial velocity
-                float cell_angle = atan2(grid_y - 1.5f, grid_x - 1.5f);
-                float mean_vx = meas_cell.radial_velocity * cos(cell_angle);
-                float mean_vy = meas_cell.radial_velocity * sin(cell_angle);
-                vx = rng.normal(mean_vx, params.stddev_velocity / 2.0f);
-                vy = rng.normal(mean_vy, params.stddev_velocity / 2.0f);
+                // Sample around measured radial velocity (셀에 캐시된 시선 방향)
+                float mean_vx = meas_cell.radial_velocity * meas_cell.los_x;
+                float mean_vy = meas_cell.radial_velocity * meas_cell.los_y;
+                vx = mean_vx + params.stddev_velocity / 2.0f * noise[0];
+                vy = mean_vy + params.stddev_velocity / 2.0f * noise[1];
             } else {
-                vx = rng.normal(0.0f, params.stddev_velocity);
-                vy = rng.normal(0.0f, params.stddev_velocity);
+                vx = params.stddev_velocity * noise[0];
+                vy = params.stddev_velocity * noise[1];
             }
 
-            birth_particles.state[i] = Vec4(grid_x, grid_y, vx, vy);
+            birth_particles.setState(i, grid_x, grid_y, vx, vy);
             birth_particles.weight[i] = is_associated ? w_A : w_UA;
             birth_particles.grid_cell_idx[i] = j;
             birth_particles.associated[i] = is_associated;
@@ -96,5 +137,23 @@ void initNewParticles(ParticlesSoA& birth_particles, const std::vector<GridCell>
     }
 }
 
+} // namespace
+
+void initNewParticles(ParticlesSoA& birth_particles, const std::vector<MeasurementCell>& meas_cells,
+                      const std::vector<float>& born_masses_array, const RandomGenerator& rng,
+                      const DOGM::Params& params, const GridWindow& window, BirthWorkspace& workspace) {
+    initNewParticlesImpl(birth_particles, [](int k) { return k; }, meas_cells, born_masses_array, rng,
+                         params, window, workspace);
+}
+
+void initNewParticles(ParticlesSoA& birth_particles, const ActiveCells& active,
+                      const std::vector<MeasurementCell>& meas_cells,
+                      const std::vector<float>& born_masses_array, const RandomGenerator& rng,
+                      const DOGM::Params& params, const GridWindow& window, BirthWorkspace& workspace) {
+    const int* list = active.list.data();
+    initNewParticlesImpl(birth_particles, [list](int k) { return list[k]; }, meas_cells, born_masses_array, rng,
+                         params, window, workspace);
+}
+
 } // namespace kernel
 } // namespace dogm
@@ -0,0 +1,62 @@
+#include "dogm/kernel/inner_region.h"
+#include "dogm/kernel/sensor_fusion.h"
+#include <algorithm>
+#include <cmath>
+
+namespace dogm {
+namespace kernel {
+
+CellRect innerRegion(const GridWindow& window, const Vec2& center, float size) {
+    CellRect region;
+    if (size <= 0.0f) return region;
+    const float half = 0.5f * size;
+    const float inv_resolution = 1.0f / window.resolution;
+    // 셀 [c, c + 1)이 [center - half, center + half]에 들어가는 c
+    region.x0 = static_cast<int>(std::ceil((center.x() - half) * inv_resolution)) - window.origin_x;
+    region.y0 = static_cast<int>(std::ceil((center.y() - half) * inv_resolution)) - window.origin_y;
+    region.x1 = static_cast<int>(std::floor((center.x() + half) * inv_resolution)) - window.origin_x;
+    region.y1 = static_cast<int>(std::floor((center.y() + half) * inv_resolution)) - window.origin_y;
+    region.x0 = clamp(region.x0, 0, window.grid_size);
+    region.y0 = clamp(region.y0, 0, window.grid_size);
+    region.x1 = clamp(region.x1, 0, window.grid_size);
+    region.y1 = clamp(region.y1, 0, window.grid_size);
+    return region;
+}
+
+void clearMeasurements(std::vector<MeasurementCell>& meas_cells, ActiveCells& measured, const GridWindow& window,
+                       const CellRect& region) {
+    if (region.empty()) return;
+    const MeasurementCell unknown = unknownMeasurementCell();
+    for (int y = region.y0; y < region.y1; ++y) {
+        for (int x = region.x0; x < region.x1; ++x) {
+            const int idx = window.physicalIndex(x, y);
+            if (!measured.contains(idx)) continue;
+            meas_cells[idx] = unknown;
+            measured.bits[idx >> 6] &= ~(uint64_t(1) << (idx & 63));
+        }
+    }
+    // list의 오름차순을 유지하며 지운 셀만 뺀다
+    measured.list.erase(std::remove_if(measured.list.begin(), measured.list.end(),
+                                       [&measured](int cell) { return !measured.contains(cell); }),
+                        measured.list.end());
+}
+
+void clearParticleWeights(ParticlesSoA& particles, std::vector<float>& weight_array,
+                          const std::vector<GridCell>& grid_cells, const GridWindow& window,
+                          const CellRect& region) {
+    if (region.empty()) return;
+    #pragma omp parallel for schedule(static)
+    for (int y = region.y0; y < region.y1; ++y) {
+        for (int x = region.x0; x < region.x1; ++x) {
+            const GridCell& cell = grid_cells[window.physicalIndex(x, y)];
+            if (cell.start_idx < 0) continue;
+            for (int i = cell.start_idx; i <= cell.end_idx; ++i) {
+                particles.weight[i] = 0.0f;
+                weight_array[i] = 0.0f;
+            }
+        }
+    }
+}
+
+} // namespace kernel
+} // namespace dogm
@@ -1,37 +1,165 @@
 #include "dogm/kernel/predict.h"
+#include "dogm/particle_codec.h"
+#include "predict_kernels.h"
+
+#include <algorithm>
 
 namespace dogm {
 namespace kernel {
 
-void predict(ParticlesSoA& particles, RandomGenerator& rng, const DOGM::Params& params, int grid_size, float dt) {
-    
-    #pragma omp parallel for
-    for (size_t i = 0; i < particles.size(); ++i) {
+namespace {
+
+// 블록 단위로 노이즈를 스택 버퍼에 생성한 뒤 SIMD 커널에 넘긴다.
+constexpr size_t kPredictBlockSize = 256;
+
+using PredictBlockFn = void (*)(const PredictCoefficients&, const PredictBlock&);
+
+PredictBlockFn selectBlockKernel(SimdLevel level) {
+    if (!isSimdLevelSupported(level)) return predictBlockScalar;
+    switch (level) {
+#ifdef DOGM_HAVE_AVX512_KERNELS
+    case SimdLevel::AVX512: return predictBlockAVX512;
+#endif
+#ifdef DOGM_HAVE_AVX2_KERNELS
+    case SimdLevel::AVX2: return predictBlockAVX2;
+#endif
+    default: return predictBlockScalar;
+    }
+}
+
+// GridIndexer::index와 같은 식
+inline int cellIndex(const PredictCoefficients& c, int px, int py) {
+    switch (c.layout) {
+    case GridLayout::Tiled:
+        return (((py >> 3) * c.tiles_per_row + (px >> 3)) << 6) | ((py & 7) << 3) | (px & 7);
+    case GridLayout::Morton:
+        return static_cast<int>(spreadBits16(px) | (spreadBits16(py) << 1));
+    default:
+        return py * c.grid_size + px;
+    }
+}
+
+PredictCoefficients makeCoefficients(const DOGM::Params& params, const GridWindow& window, float dt) {
+    return PredictCoefficients{dt, params.stddev_process_noise_position, params.stddev_process_noise_velocity,
+                               params.persistence_prob, window.grid_size, window.offset_x, window.offset_y,
+                               window.indexer.layout, window.indexer.tiles_per_row};
+}
+
+} // namespace
+
+void predictBlockScalar(const PredictCoefficients& c, const PredictBlock& b) {
+    for (size_t k = 0; k < b.count; ++k) {
         // State transition
-        particles.state[i][0] += particles.state[i][2] * dt; // x += vx * dt
-        particles.state[i][1] += particles.state[i][3] * dt; // y += vy * dt
-
-        // Add process noise
-        particles.state[i][0] += rng.normal(0.0f, params.stddev_process_noise_position);
-        particles.state[i][1] += rng.normal(0.0f, params.stddev_process_noise_position);
-        particles.state[i][2] += rng.normal(0.0f, params.stddev_process_noise_velocity);
-        particles.state[i][3] += rng.normal(0.0f, params.stddev_process_noise_velocity);
-        
+        float x = b.x[k] + b.vx[k] * c.dt; // x += vx * dt
+        float y = b.y[k] + b.vy[k] * c.dt; // y += vy * dt
+
+        // Add process noise (파티클 인덱스별 독립 스트림)
+        x = x + c.stddev_position * b.noise[0][k];
+        y = y + c.stddev_position * b.noise[1][k];
+        b.vx[k] = b.vx[k] + c.stddev_velocity * b.noise[2][k];
+        b.vy[k] = b.vy[k] + c.stddev_velocity * b.noise[3][k];
+        b.x[k] = x;
+        b.y[k] = y;
+
         // Update weight
-        particles.weight[i] *= params.persistence_prob;
-        
-        // Update grid cell index and check boundaries
-        const auto& state = particles.state[i];
-        float x = state[0];
-        float y = state[1];
-
-        if (x < 0 || x >= grid_size || y < 0 || y >= grid_size) {
-            particles.weight[i] = 0.0f; // Particle is out of bounds
+        float w = b.weight[k] * c.persistence;
+        if (x < 0 || x >= c.grid_size || y < 0 || y >= c.grid_size) {
+            w = 0.0f; // Particle is out of bounds
+        }
+        b.weight[k] = w;
+
+        // Update grid cell index (로컬 셀 -> ring buffer 저장 위치)
+        int pos_x = clamp(static_cast<int>(x), 0, c.grid_size - 1) + c.offset_x;
+        int pos_y = clamp(static_cast<int>(y), 0, c.grid_size - 1) + c.offset_y;
+        if (pos_x >= c.grid_size) pos_x -= c.grid_size;
+        if (pos_y >= c.grid_size) pos_y -= c.grid_size;
+        b.grid_cell_idx[k] = cellIndex(c, pos_x, pos_y);
+    }
+}
+
+void predict(ParticlesSoA& particles, const RandomGenerator& rng, const DOGM::Params& params,
+             const GridWindow& window, float dt) {
+    predict(particles, rng, params, window, dt, detectSimdLevel());
+}
+
+void predict(ParticlesSoA& particles, const RandomGenerator& rng, const DOGM::Params& params,
+             const GridWindow& window, float dt, SimdLevel level) {
+    const PredictBlockFn kernel = selectBlockKernel(level);
+    const PredictCoefficients coeffs = makeCoefficients(params, window, dt);
+
+    const size_t count = particles.size();
+    const int block_count = static_cast<int>((count + kPredictBlockSize - 1) / kPredictBlockSize);
+
+    #pragma omp parallel for schedule(static)
+    for (int blk = 0; blk < block_count; ++blk) {
+        alignas(64) float noise[4][kPredictBlockSize];
+        const size_t first = static_cast<size_t>(blk) * kPredictBlockSize;
+        const size_t n = std::min(kPredictBlockSize, count - first);
+        rng.normal4Batch(RandomStream::Predict, static_cast<uint32_t>(first), n,
+                         noise[0], noise[1], noise[2], noise[3]);
+
+        PredictBlock block{particles.x.data() + first, particles.y.data() + first,
+                           particles.vx.data() + first, particles.vy.data() + first,
+                           particles.weight.data() + first, particles.grid_cell_idx.data() + first,
+                           {noise[0], noise[1], noise[2], noise[3]}, n};
+        kernel(coeffs, block);
+    }
+}
+
+void predict(CompactParticlesSoA& particles, const RandomGenerator& rng, const DOGM::Params& params,
+             const GridWindow& window, float dt) {
+    predict(particles, rng, params, window, dt, detectSimdLevel());
+}
+
+void predict(CompactParticlesSoA& particles, const RandomGenerator& rng, const DOGM::Params& params,
+             const GridWindow& window, float dt, SimdLevel level) {
+    const PredictBlockFn kernel = selectBlockKernel(level);
+    const PredictCoefficients coeffs = makeCoefficients(params, window, dt);
+
+    const size_t count = particles.size();
+    const int block_count = static_cast<int>((count + kPredictBlockSize - 1) / kPredictBlockSize);
+
+    #pragma omp parallel for schedule(static)
+    for (int blk = 0; blk < block_count; ++blk) {
+        alignas(64) float noise[4][kPredictBlockSize];
+        alignas(64) float x[kPredictBlockSize];
+        alignas(64) float y[kPredictBlockSize];
+        alignas(64) float vx[kPredictBlockSize];
+        alignas(64) float vy[kPredictBlockSize];
+        alignas(64) float weight[kPredictBlockSize];
+        alignas(64) int grid_cell_idx[kPredictBlockSize];
+        const size_t first = static_cast<size_t>(blk) * kPredictBlockSize;
+        const int n = static_cast<int>(std::min(kPredictBlockSize, count - first));
+        rng.normal4Batch(RandomStream::Predict, static_cast<uint32_t>(first), n,
+                         noise[0], noise[1], noise[2], noise[3]);
+
+        int16_t* cell_x = particles.cell_x.data() + first;
+        int16_t* cell_y = particles.cell_y.data() + first;
+        uint16_t* offset_x = particles.offset_x.data() + first;
+        uint16_t* offset_y = particles.offset_y.data() + first;
+        uint16_t* half_vx = particles.vx.data() + first;
+        uint16_t* half_vy = particles.vy.data() + first;
+
+        #pragma omp simd
+        for (int k = 0; k < n; ++k) {
+            x[k] = decodePosition(cell_x[k], offset_x[k]);
+            y[k] = decodePosition(cell_y[k], offset_y[k]);
+            vx[k] = halfToFloat(half_vx[k]);
+            vy[k] = halfToFloat(half_vy[k]);
+            weight[k] = 0.0f;
+        }
+
+        PredictBlock block{x, y, vx, vy, weight, grid_cell_idx, {noise[0], noise[1], noise[2], noise[3]},
+                           static_cast<size_t>(n)};
+        kernel(coeffs, block);
+
+        #pragma omp simd
+        for (int k = 0; k < n; ++k) {
+            encodePosition(x[k], cell_x[k], offset_x[k]);
+            encodePosition(y[k], cell_y[k], offset_y[k]);
+            half_vx[k] = floatToHalf(vx[k]);
+            half_vy[k] = floatToHalf(vy[k]);
         }
-        
-        int pos_x = clamp(static_cast<int>(x), 0, grid_size - 1);
-        int pos_y = clamp(static_cast<int>(y), 0, grid_size - 1);
-        particles.grid_cell_idx[i] = pos_y * grid_size + pos_x;
     }
 }
 
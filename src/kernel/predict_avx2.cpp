@@ -0,0 +1,97 @@
+// -mavx2 로 컴파일된다 (CMakeLists.txt 참고). AVX2를 지원하는 CPU에서만 호출해야 한다.
+#include "predict_kernels.h"
+
+#include <immintrin.h>
+
+namespace dogm {
+namespace kernel {
+
+namespace {
+
+// GridIndexer::index의 8-lane 버전
+__m256i spreadBits16(__m256i v) {
+    v = _mm256_and_si256(_mm256_or_si256(v, _mm256_slli_epi32(v, 8)), _mm256_set1_epi32(0x00FF00FF));
+    v = _mm256_and_si256(_mm256_or_si256(v, _mm256_slli_epi32(v, 4)), _mm256_set1_epi32(0x0F0F0F0F));
+    v = _mm256_and_si256(_mm256_or_si256(v, _mm256_slli_epi32(v, 2)), _mm256_set1_epi32(0x33333333));
+    v = _mm256_and_si256(_mm256_or_si256(v, _mm256_slli_epi32(v, 1)), _mm256_set1_epi32(0x55555555));
+    return v;
+}
+
+__m256i cellIndex(const PredictCoefficients& c, __m256i ix, __m256i iy) {
+    switch (c.layout) {
+    case GridLayout::Tiled: {
+        const __m256i seven = _mm256_set1_epi32(7);
+        __m256i tile = _mm256_add_epi32(_mm256_mullo_epi32(_mm256_srli_epi32(iy, 3), _mm256_set1_epi32(c.tiles_per_row)),
+                                        _mm256_srli_epi32(ix, 3));
+        __m256i inner = _mm256_or_si256(_mm256_slli_epi32(_mm256_and_si256(iy, seven), 3), _mm256_and_si256(ix, seven));
+        return _mm256_or_si256(_mm256_slli_epi32(tile, 6), inner);
+    }
+    case GridLayout::Morton:
+        return _mm256_or_si256(spreadBits16(ix), _mm256_slli_epi32(spreadBits16(iy), 1));
+    default:
+        return _mm256_add_epi32(_mm256_mullo_epi32(iy, _mm256_set1_epi32(c.grid_size)), ix);
+    }
+}
+
+} // namespace
+
+void predictBlockAVX2(const PredictCoefficients& c, const PredictBlock& b) {
+    const __m256 dt = _mm256_set1_ps(c.dt);
+    const __m256 sp = _mm256_set1_ps(c.stddev_position);
+    const __m256 sv = _mm256_set1_ps(c.stddev_velocity);
+    const __m256 persistence = _mm256_set1_ps(c.persistence);
+    const __m256 zero = _mm256_setzero_ps();
+    const __m256 limit = _mm256_set1_ps(static_cast<float>(c.grid_size));
+    const __m256i izero = _mm256_setzero_si256();
+    const __m256i imax = _mm256_set1_epi32(c.grid_size - 1);
+    const __m256i stride = _mm256_set1_epi32(c.grid_size);
+    const __m256i offset_x = _mm256_set1_epi32(c.offset_x);
+    const __m256i offset_y = _mm256_set1_epi32(c.offset_y);
+
+    size_t k = 0;
+    for (; k + 8 <= b.count; k += 8) {
+        __m256 x = _mm256_loadu_ps(b.x + k);
+        __m256 y = _mm256_loadu_ps(b.y + k);
+        __m256 vx = _mm256_loadu_ps(b.vx + k);
+        __m256 vy = _mm256_loadu_ps(b.vy + k);
+
+        // scalar 경로와 같은 순서로 mul/add (FMA 사용 안 함)
+        x = _mm256_add_ps(x, _mm256_mul_ps(vx, dt));
+        y = _mm256_add_ps(y, _mm256_mul_ps(vy, dt));
+        x = _mm256_add_ps(x, _mm256_mul_ps(sp, _mm256_loadu_ps(b.noise[0] + k)));
+        y = _mm256_add_ps(y, _mm256_mul_ps(sp, _mm256_loadu_ps(b.noise[1] + k)));
+        vx = _mm256_add_ps(vx, _mm256_mul_ps(sv, _mm256_loadu_ps(b.noise[2] + k)));
+        vy = _mm256_add_ps(vy, _mm256_mul_ps(sv, _mm256_loadu_ps(b.noise[3] + k)));
+
+        __m256 out = _mm256_or_ps(_mm256_cmp_ps(x, zero, _CMP_LT_OQ), _mm256_cmp_ps(x, limit, _CMP_GE_OQ));
+        out = _mm256_or_ps(out, _mm256_cmp_ps(y, zero, _CMP_LT_OQ));
+        out = _mm256_or_ps(out, _mm256_cmp_ps(y, limit, _CMP_GE_OQ));
+        __m256 w = _mm256_mul_ps(_mm256_loadu_ps(b.weight + k), persistence);
+        w = _mm256_andnot_ps(out, w);
+
+        __m256i ix = _mm256_min_epi32(_mm256_max_epi32(_mm256_cvttps_epi32(x), izero), imax);
+        __m256i iy = _mm256_min_epi32(_mm256_max_epi32(_mm256_cvttps_epi32(y), izero), imax);
+        // ring buffer wrap: ix + offset >= grid_size 이면 grid_size를 뺀다
+        ix = _mm256_add_epi32(ix, offset_x);
+        iy = _mm256_add_epi32(iy, offset_y);
+        ix = _mm256_sub_epi32(ix, _mm256_and_si256(_mm256_cmpgt_epi32(ix, imax), stride));
+        iy = _mm256_sub_epi32(iy, _mm256_and_si256(_mm256_cmpgt_epi32(iy, imax), stride));
+        __m256i idx = cellIndex(c, ix, iy);
+
+        _mm256_storeu_ps(b.x + k, x);
+        _mm256_storeu_ps(b.y + k, y);
+        _mm256_storeu_ps(b.vx + k, vx);
+        _mm256_storeu_ps(b.vy + k, vy);
+        _mm256_storeu_ps(b.weight + k, w);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(b.grid_cell_idx + k), idx);
+    }
+
+    if (k < b.count) {
+        PredictBlock tail{b.x + k, b.y + k, b.vx + k, b.vy + k, b.weight + k, b.grid_cell_idx + k,
+                          {b.noise[0] + k, b.noise[1] + k, b.noise[2] + k, b.noise[3] + k}, b.count - k};
+        predictBlockScalar(c, tail);
+    }
+}
+
+} // namespace kernel
+} // namespace dogm
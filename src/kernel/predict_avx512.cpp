@@ -0,0 +1,92 @@
+// -mavx512f 로 컴파일된다 (CMakeLists.txt 참고). AVX-512F를 지원하는 CPU에서만 호출해야 한다.
+#include "predict_kernels.h"
+
+#include <immintrin.h>
+
+namespace dogm {
+namespace kernel {
+
+namespace {
+
+// GridIndexer::index의 16-lane 버전
+__m512i spreadBits16(__m512i v) {
+    v = _mm512_and_si512(_mm512_or_si512(v, _mm512_slli_epi32(v, 8)), _mm512_set1_epi32(0x00FF00FF));
+    v = _mm512_and_si512(_mm512_or_si512(v, _mm512_slli_epi32(v, 4)), _mm512_set1_epi32(0x0F0F0F0F));
+    v = _mm512_and_si512(_mm512_or_si512(v, _mm512_slli_epi32(v, 2)), _mm512_set1_epi32(0x33333333));
+    v = _mm512_and_si512(_mm512_or_si512(v, _mm512_slli_epi32(v, 1)), _mm512_set1_epi32(0x55555555));
+    return v;
+}
+
+__m512i cellIndex(const PredictCoefficients& c, __m512i ix, __m512i iy) {
+    switch (c.layout) {
+    case GridLayout::Tiled: {
+        const __m512i seven = _mm512_set1_epi32(7);
+        __m512i tile = _mm512_add_epi32(_mm512_mullo_epi32(_mm512_srli_epi32(iy, 3), _mm512_set1_epi32(c.tiles_per_row)),
+                                        _mm512_srli_epi32(ix, 3));
+        __m512i inner = _mm512_or_si512(_mm512_slli_epi32(_mm512_and_si512(iy, seven), 3), _mm512_and_si512(ix, seven));
+        return _mm512_or_si512(_mm512_slli_epi32(tile, 6), inner);
+    }
+    case GridLayout::Morton:
+        return _mm512_or_si512(spreadBits16(ix), _mm512_slli_epi32(spreadBits16(iy), 1));
+    default:
+        return _mm512_add_epi32(_mm512_mullo_epi32(iy, _mm512_set1_epi32(c.grid_size)), ix);
+    }
+}
+
+} // namespace
+
+void predictBlockAVX512(const PredictCoefficients& c, const PredictBlock& b) {
+    const __m512 dt = _mm512_set1_ps(c.dt);
+    const __m512 sp = _mm512_set1_ps(c.stddev_position);
+    const __m512 sv = _mm512_set1_ps(c.stddev_velocity);
+    const __m512 persistence = _mm512_set1_ps(c.persistence);
+    const __m512 zero = _mm512_setzero_ps();
+    const __m512 limit = _mm512_set1_ps(static_cast<float>(c.grid_size));
+    const __m512i izero = _mm512_setzero_si512();
+    const __m512i imax = _mm512_set1_epi32(c.grid_size - 1);
+    const __m512i stride = _mm512_set1_epi32(c.grid_size);
+    const __m512i offset_x = _mm512_set1_epi32(c.offset_x);
+    const __m512i offset_y = _mm512_set1_epi32(c.offset_y);
+
+    // 마지막 블록은 마스크 load/store로 처리하므로 scalar tail이 없다
+    for (size_t k = 0; k < b.count; k += 16) {
+        const size_t remaining = b.count - k;
+        const __mmask16 m = remaining >= 16 ? static_cast<__mmask16>(0xFFFF)
+                                            : static_cast<__mmask16>((1u << remaining) - 1u);
+
+        __m512 x = _mm512_maskz_loadu_ps(m, b.x + k);
+        __m512 y = _mm512_maskz_loadu_ps(m, b.y + k);
+        __m512 vx = _mm512_maskz_loadu_ps(m, b.vx + k);
+        __m512 vy = _mm512_maskz_loadu_ps(m, b.vy + k);
+
+        // scalar 경로와 같은 순서로 mul/add (FMA 사용 안 함)
+        x = _mm512_add_ps(x, _mm512_mul_ps(vx, dt));
+        y = _mm512_add_ps(y, _mm512_mul_ps(vy, dt));
+        x = _mm512_add_ps(x, _mm512_mul_ps(sp, _mm512_maskz_loadu_ps(m, b.noise[0] + k)));
+        y = _mm512_add_ps(y, _mm512_mul_ps(sp, _mm512_maskz_loadu_ps(m, b.noise[1] + k)));
+        vx = _mm512_add_ps(vx, _mm512_mul_ps(sv, _mm512_maskz_loadu_ps(m, b.noise[2] + k)));
+        vy = _mm512_add_ps(vy, _mm512_mul_ps(sv, _mm512_maskz_loadu_ps(m, b.noise[3] + k)));
+
+        __mmask16 out = _mm512_cmp_ps_mask(x, zero, _CMP_LT_OQ) | _mm512_cmp_ps_mask(x, limit, _CMP_GE_OQ) |
+                        _mm512_cmp_ps_mask(y, zero, _CMP_LT_OQ) | _mm512_cmp_ps_mask(y, limit, _CMP_GE_OQ);
+        __m512 w = _mm512_mul_ps(_mm512_maskz_loadu_ps(m, b.weight + k), persistence);
+        w = _mm512_maskz_mov_ps(static_cast<__mmask16>(~out), w);
+
+        __m512i ix = _mm512_add_epi32(_mm512_min_epi32(_mm512_max_epi32(_mm512_cvttps_epi32(x), izero), imax), offset_x);
+        __m512i iy = _mm512_add_epi32(_mm512_min_epi32(_mm512_max_epi32(_mm512_cvttps_epi32(y), izero), imax), offset_y);
+        // ring buffer wrap: ix + offset >= grid_size 이면 grid_size를 뺀다
+        ix = _mm512_mask_sub_epi32(ix, _mm512_cmpgt_epi32_mask(ix, imax), ix, stride);
+        iy = _mm512_mask_sub_epi32(iy, _mm512_cmpgt_epi32_mask(iy, imax), iy, stride);
+        __m512i idx = cellIndex(c, ix, iy);
+
+        _mm512_mask_storeu_ps(b.x + k, m, x);
+        _mm512_mask_storeu_ps(b.y + k, m, y);
+        _mm512_mask_storeu_ps(b.vx + k, m, vx);
+        _mm512_mask_storeu_ps(b.vy + k, m, vy);
+        _mm512_mask_storeu_ps(b.weight + k, m, w);
+        _mm512_mask_storeu_epi32(b.grid_cell_idx + k, m, idx);
+    }
+}
+
+} // namespace kernel
+} // namespace dogm
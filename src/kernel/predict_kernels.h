@@ -0,0 +1,47 @@
+#pragma once
+
+#include "dogm/grid_layout.h"
+#include <cstddef>
+
+// predict 커널의 SIMD 수준별 블록 구현 (라이브러리 내부용).
+// AVX2/AVX-512 구현은 해당 ISA 플래그로만 컴파일되는 별도 번역 단위에 있다.
+
+namespace dogm {
+namespace kernel {
+
+struct PredictCoefficients {
+    float dt;
+    float stddev_position;
+    float stddev_velocity;
+    float persistence;
+    int grid_size;
+    int offset_x;  // GridWindow ring buffer offset
+    int offset_y;
+    GridLayout layout;  // GridIndexer와 같은 저장 순서로 grid_cell_idx를 계산한다
+    int tiles_per_row;
+};
+
+// 한 블록의 파티클 열 포인터. noise는 normal4Batch의 planar 출력.
+struct PredictBlock {
+    float* x;
+    float* y;
+    float* vx;
+    float* vy;
+    float* weight;
+    int* grid_cell_idx;
+    const float* noise[4];
+    size_t count;
+};
+
+void predictBlockScalar(const PredictCoefficients& c, const PredictBlock& b);
+
+#ifdef DOGM_HAVE_AVX2_KERNELS
+void predictBlockAVX2(const PredictCoefficients& c, const PredictBlock& b);
+#endif
+
+#ifdef DOGM_HAVE_AVX512_KERNELS
+void predictBlockAVX512(const PredictCoefficients& c, const PredictBlock& b);
+#endif
+
+} // namespace kernel
+} // namespace dogm
@@ -0,0 +1,145 @@
+#include "dogm/kernel/ray_casting.h"
+#include "dogm/common.h"
+#include <omp.h>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace dogm {
+namespace kernel {
+
+namespace {
+
+// Slab 방식으로 [t0, t1] 구간을 축 방향 [lo, hi) 범위로 자른다.
+inline bool clipAxis(float origin, float dir, float lo, float hi, float& t0, float& t1) {
+    if (dir == 0.0f) {
+        return origin >= lo && origin < hi;
+    }
+    float ta = (lo - origin) / dir;
+    float tb = (hi - origin) / dir;
+    if (ta > tb) std::swap(ta, tb);
+    t0 = std::max(t0, ta);
+    t1 = std::min(t1, tb);
+    return t0 <= t1;
+}
+
+// 타일 슬롯에 라벨을 더하고 스레드의 touched bitmap에 표시한다.
+inline void markCell(uint8_t* tile, int idx, uint8_t label, uint64_t* touched) {
+    touched[idx >> 6] |= uint64_t(1) << (idx & 63);
+    tile[idx] |= label;
+}
+
+// 하나의 빔을 셀 단위로 순회. 좌표와 t는 모두 셀 단위.
+void traverseBeam(float ox, float oy, float dx, float dy, float t_end, int grid_size, uint8_t* tile,
+                  uint64_t* touched) {
+    const int end_x = static_cast<int>(std::floor(ox + dx * t_end));
+    const int end_y = static_cast<int>(std::floor(oy + dy * t_end));
+    const bool end_inside = end_x >= 0 && end_x < grid_size && end_y >= 0 && end_y < grid_size;
+
+    float t0 = 0.0f, t1 = t_end;
+    const float extent = static_cast<float>(grid_size);
+    if (clipAxis(ox, dx, 0.0f, extent, t0, t1) && clipAxis(oy, dy, 0.0f, extent, t0, t1)) {
+        int ix = clamp(static_cast<int>(std::floor(ox + dx * t0)), 0, grid_size - 1);
+        int iy = clamp(static_cast<int>(std::floor(oy + dy * t0)), 0, grid_size - 1);
+
+        const float inf = std::numeric_limits<float>::infinity();
+        const int step_x = (dx > 0.0f) ? 1 : -1;
+        const int step_y = (dy > 0.0f) ? 1 : -1;
+        const float t_delta_x = (dx != 0.0f) ? std::abs(1.0f / dx) : inf;
+        const float t_delta_y = (dy != 0.0f) ? std::abs(1.0f / dy) : inf;
+        float t_max_x = (dx != 0.0f) ? ((ix + (dx > 0.0f ? 1 : 0)) - ox) / dx : inf;
+        float t_max_y = (dy != 0.0f) ? ((iy + (dy > 0.0f ? 1 : 0)) - oy) / dy : inf;
+
+        while (!(ix == end_x && iy == end_y)) {
+            markCell(tile, iy * grid_size + ix, RAY_CELL_FREE, touched);
+
+            if (t_max_x < t_max_y) {
+                if (t_max_x > t1) break;
+                ix += step_x;
+                t_max_x += t_delta_x;
+            } else {
+                if (t_max_y > t1) break;
+                iy += step_y;
+                t_max_y += t_delta_y;
+            }
+            if (ix < 0 || ix >= grid_size || iy < 0 || iy >= grid_size) break;
+        }
+    }
+
+    if (end_inside) {
+        markCell(tile, end_y * grid_size + end_x, RAY_CELL_OCCUPIED, touched);
+    }
+}
+
+} // namespace
+
+void RayCastWorkspace::reserve(int cells, int threads) {
+    // 스레드 수가 줄어든 호출(예: 스레드 수를 제한한 파이프라인 스레드)은 기존 버퍼의 앞부분만 쓴다
+    if (cells == cell_count && threads <= thread_count) return;
+    const size_t words = (static_cast<size_t>(cells) + 63) / 64;
+    labels.assign(cells, RAY_CELL_UNKNOWN);
+    tiles.assign(static_cast<size_t>(threads) * cells, RAY_CELL_UNKNOWN);
+    thread_touched.assign(static_cast<size_t>(threads) * words, 0);
+    touched.resize(cells);
+    cell_count = cells;
+    thread_count = threads;
+}
+
+void castLidarRays(const float* ranges, const float* angles, size_t beam_count,
+                   int grid_size, float resolution,
+                   const Vec2& origin, RayCastWorkspace& ws) {
+    const int cell_count = grid_size * grid_size;
+    const int max_threads = omp_get_max_threads();
+
+    // 타일과 스레드 bitmap은 병합 단계에서, 라벨은 아래에서 touched 셀만 다시 0으로 비운다.
+    ws.reserve(cell_count, max_threads);
+    const int words = static_cast<int>(ws.touched.bits.size());
+    for (int cell : ws.touched.list) ws.labels[cell] = RAY_CELL_UNKNOWN;
+    ws.touched.clear();
+
+    const float inv_resolution = 1.0f / resolution;
+    const float ox = origin.x() * inv_resolution;
+    const float oy = origin.y() * inv_resolution;
+
+    #pragma omp parallel
+    {
+        const int tid = omp_get_thread_num();
+        uint8_t* tile = &ws.tiles[static_cast<size_t>(tid) * cell_count];
+        uint64_t* touched = &ws.thread_touched[static_cast<size_t>(tid) * words];
+
+        #pragma omp for schedule(dynamic, 16)
+        for (int i = 0; i < static_cast<int>(beam_count); ++i) {
+            // 빔 방향은 빔당 한 번만 계산
+            const float angle = angles[i];
+            const float dx = std::cos(angle);
+            const float dy = std::sin(angle);
+            traverseBeam(ox, oy, dx, dy, ranges[i] * inv_resolution, grid_size, tile, touched);
+        }
+    }
+
+    // 스레드별 타일을 셀 단위 OR(= max)로 병합하고 타일과 bitmap을 비운다.
+    // word 단위로 나누므로 스레드끼리 겹치지 않으며, 빔이 지나간 셀만 방문한다.
+    #pragma omp parallel for schedule(static, 64)
+    for (int w = 0; w < words; ++w) {
+        uint64_t merged = 0;
+        for (int t = 0; t < max_threads; ++t) {
+            uint64_t& slot = ws.thread_touched[static_cast<size_t>(t) * words + w];
+            uint64_t word = slot;
+            if (!word) continue;
+            slot = 0;
+            merged |= word;
+            uint8_t* tile = &ws.tiles[static_cast<size_t>(t) * cell_count];
+            while (word) {
+                const int cell = w * 64 + __builtin_ctzll(word);
+                ws.labels[cell] |= tile[cell];
+                tile[cell] = RAY_CELL_UNKNOWN;
+                word &= word - 1;
+            }
+        }
+        ws.touched.bits[w] = merged;
+    }
+    ws.touched.buildList();
+}
+
+} // namespace kernel
+} // namespace dogm
@@ -1,52 +1,210 @@
 #include "dogm/kernel/resampling.h"
+#include "dogm/kernel/init.h"
+#include "dogm/particle_codec.h"
+#include <algorithm>
 #include <vector>
 #include <numeric>
+#include <cmath>
 
 namespace dogm {
 namespace kernel {
 
-void resample(const ParticlesSoA& particles, ParticlesSoA& particles_next,
-              const ParticlesSoA& birth_particles,
-              const std::vector<float>& weight_array,
-              const std::vector<float>& birth_weight_array,
-              RandomGenerator& rng, const DOGM::Params& params) {
+namespace {
+
+// 정렬된 위치 positions(i)에 대해 lower_bound(accum_weights, positions(i))를 구한다.
+// 출력 구간을 스레드별로 나누고, 구간 시작에서만 이진 탐색한 뒤 누적합을 따라 선형으로 전진한다 (merge path).
+template<typename PositionFn>
+void selectSortedPositions(const std::vector<float>& accum_weights, int first, int count,
+                           std::vector<int>& ancestors, PositionFn position, bool parallel) {
+    const int last_idx = static_cast<int>(accum_weights.size()) - 1;
+
+    auto select_range = [&](int begin, int end) {
+        if (begin >= end) return;
+        int j = static_cast<int>(std::lower_bound(accum_weights.begin(), accum_weights.end(), position(begin)) -
+                                 accum_weights.begin());
+        for (int i = begin; i < end; ++i) {
+            const float pos = position(i);
+            while (j < last_idx && accum_weights[j] < pos) ++j;
+            ancestors[first + i] = std::min(j, last_idx);
+        }
+    };
+
+    if (!parallel) {
+        select_range(0, count);
+        return;
+    }
+
+    #pragma omp parallel
+    {
+        const int num_threads = omp_get_num_threads();
+        const int tid = omp_get_thread_num();
+        const int begin = static_cast<int>(static_cast<long long>(count) * tid / num_threads);
+        const int end = static_cast<int>(static_cast<long long>(count) * (tid + 1) / num_threads);
+        select_range(begin, end);
+    }
+}
+
+void selectMultinomial(const std::vector<float>& accum_weights, int sample_count,
+                       const RandomGenerator& rng, std::vector<int>& ancestors) {
+    const float total_weight = accum_weights.back();
+    const int last_idx = static_cast<int>(accum_weights.size()) - 1;
+
+    #pragma omp parallel for
+    for (int i = 0; i < sample_count; ++i) {
+        float r = rng.uniform(RandomStream::Resample, static_cast<uint32_t>(i), 0.0f, total_weight);
+        auto it = std::lower_bound(accum_weights.begin(), accum_weights.end(), r);
+        ancestors[i] = std::min(static_cast<int>(std::distance(accum_weights.begin(), it)), last_idx);
+    }
+}
+
+void selectResidual(const std::vector<float>& joint_weights, int sample_count, const RandomGenerator& rng,
+                    ResamplingWorkspace& workspace) {
+    const int total_count = static_cast<int>(joint_weights.size());
+    const float total_weight = workspace.accum_weights.back();
+    const float scale = sample_count / total_weight;
+
+    auto& copies = workspace.replication_offsets;
+    auto& residual_accum = workspace.residual_accum;
+    copies.resize(total_count);
+    residual_accum.resize(total_count);
 
-    size_t persistent_count = particles.size();
-    size_t birth_count = birth_particles.size();
-    size_t total_count = persistent_count + birth_count;
+    // 결정적 복제 횟수 floor(N * w_j)와 나머지 가중치
+    #pragma omp parallel for
+    for (int j = 0; j < total_count; ++j) {
+        float expected = joint_weights[j] * scale;
+        int n = static_cast<int>(expected);
+        copies[j] = n;
+        residual_accum[j] = expected - n;
+    }
+
+    accumulate(copies);
+    accumulate(residual_accum);
+    const int deterministic_count = std::min(copies.back(), sample_count);
+
+    #pragma omp parallel for schedule(dynamic, 1024)
+    for (int j = 0; j < total_count; ++j) {
+        int begin = (j == 0) ? 0 : copies[j - 1];
+        int end = std::min(copies[j], deterministic_count);
+        for (int i = begin; i < end; ++i) {
+            workspace.ancestors[i] = j;
+        }
+    }
+
+    // 남은 R개는 나머지 가중치에 대해 systematic resampling
+    const int residual_count = sample_count - deterministic_count;
+    const float residual_total = residual_accum.back();
+    if (residual_count <= 0) return;
+    if (residual_total <= 0.0f) {
+        // 수치 오차로 나머지가 없으면 가장 무거운 파티클을 복제
+        int heaviest = static_cast<int>(std::max_element(joint_weights.begin(), joint_weights.end()) -
+                                        joint_weights.begin());
+        std::fill(workspace.ancestors.begin() + deterministic_count, workspace.ancestors.end(), heaviest);
+        return;
+    }
+
+    const float step = residual_total / residual_count;
+    const float offset = rng.uniform(RandomStream::Resample, 0u) * step;
+    selectSortedPositions(residual_accum, deterministic_count, residual_count, workspace.ancestors,
+                          [=](int i) { return offset + i * step; }, true);
+}
+
+} // namespace
+
+void selectAncestors(ResamplingMethod method, const std::vector<float>& joint_weights, int sample_count,
+                     const RandomGenerator& rng, ResamplingWorkspace& workspace) {
+    const std::vector<float>& accum_weights = workspace.accum_weights;
+    const float total_weight = accum_weights.back();
+    workspace.ancestors.resize(sample_count);
+
+    switch (method) {
+    case ResamplingMethod::Multinomial:
+        selectMultinomial(accum_weights, sample_count, rng, workspace.ancestors);
+        break;
+
+    case ResamplingMethod::Systematic:
+    case ResamplingMethod::ParallelSystematic: {
+        // 프레임당 난수 하나: u_i = (i + u) / N
+        const float step = total_weight / sample_count;
+        const float offset = rng.uniform(RandomStream::Resample, 0u) * step;
+        selectSortedPositions(accum_weights, 0, sample_count, workspace.ancestors,
+                              [=](int i) { return offset + i * step; },
+                              method == ResamplingMethod::ParallelSystematic);
+        break;
+    }
+
+    case ResamplingMethod::Stratified: {
+        // 층마다 독립 난수: u_i = (i + U_i) / N
+        const float step = total_weight / sample_count;
+        selectSortedPositions(accum_weights, 0, sample_count, workspace.ancestors,
+                              [&](int i) {
+                                  return (i + rng.uniform(RandomStream::Resample, static_cast<uint32_t>(i))) * step;
+                              }, true);
+        break;
+    }
+
+    case ResamplingMethod::Residual:
+        selectResidual(joint_weights, sample_count, rng, workspace);
+        break;
+    }
+}
 
-    std::vector<float> joint_weights;
-    joint_weights.reserve(total_count);
-    joint_weights.insert(joint_weights.end(), weight_array.begin(), weight_array.end());
-    joint_weights.insert(joint_weights.end(), birth_weight_array.begin(), birth_weight_array.end());
+namespace {
 
-    std::vector<float> accum_weights;
+// [persistent | birth] 가중치의 누적합을 만들고 sample_count개의 조상을 고른다 (workspace.ancestors).
+// 가중치 합이 0 이하면 false를 반환한다.
+bool selectJointAncestors(const std::vector<float>& weight_array, const std::vector<float>& birth_weight_array,
+                          int sample_count, const RandomGenerator& rng, const DOGM::Params& params,
+                          ResamplingWorkspace& workspace, float& new_weight) {
+    const int persistent_count = static_cast<int>(weight_array.size());
+    const int total_count = persistent_count + static_cast<int>(birth_weight_array.size());
+
+    // 이전 프레임의 버퍼를 재사용 (크기가 같으면 할당 없음)
+    auto& joint_weights = workspace.joint_weights;
+    auto& accum_weights = workspace.accum_weights;
+    joint_weights.resize(total_count);
+    accum_weights.resize(total_count);
+
+    std::copy(weight_array.begin(), weight_array.end(), joint_weights.begin());
+    std::copy(birth_weight_array.begin(), birth_weight_array.end(), joint_weights.begin() + persistent_count);
     accumulate(joint_weights, accum_weights);
     
     float total_weight = accum_weights.empty() ? 0.0f : accum_weights.back();
+    if (total_weight <= 0.0f) return false;
+
+    selectAncestors(params.resampling_method, joint_weights, sample_count, rng, workspace);
+    new_weight = total_weight / sample_count;
+    return true;
+}
+
+} // namespace
+
+void resample(const ParticlesSoA& particles, ParticlesSoA& particles_next,
+              const ParticlesSoA& birth_particles,
+              const std::vector<float>& weight_array,
+              const std::vector<float>& birth_weight_array,
+              const RandomGenerator& rng, const DOGM::Params& params,
+              const GridWindow& window, ResamplingWorkspace& workspace) {
+
+    const int persistent_count = static_cast<int>(particles.size());
+    const int sample_count = static_cast<int>(particles_next.size());
+    float new_weight = 0.0f;
 
-    if (total_weight <= 0.0f) {
+    if (!selectJointAncestors(weight_array, birth_weight_array, sample_count, rng, params, workspace, new_weight)) {
         // Failsafe: if all weights are zero, reinitialize
-        kernel::initParticles(particles_next, rng, params.init_max_velocity, static_cast<int>(sqrt(params.size / params.resolution)));
+        kernel::initParticles(particles_next, rng, params.init_max_velocity, window);
         return;
     }
 
-    float new_weight = total_weight / particles_next.size();
-
-    // Multinomial resampling
     #pragma omp parallel for
-    for (size_t i = 0; i < particles_next.size(); ++i) {
-        float r = rng.uniform(0.0f, total_weight);
-        
-        auto it = std::lower_bound(accum_weights.begin(), accum_weights.end(), r);
-        int idx = std::distance(accum_weights.begin(), it);
+    for (int i = 0; i < sample_count; ++i) {
+        int idx = workspace.ancestors[i];
         
         if (idx < persistent_count) {
-            particles_next.state[i] = particles.state[idx];
+            particles_next.copyStateFrom(i, particles, idx);
             particles_next.associated[i] = particles.associated[idx];
         } else {
             int birth_idx = idx - persistent_count;
-            particles_next.state[i] = birth_particles.state[birth_idx];
+            particles_next.copyStateFrom(i, birth_particles, birth_idx);
             particles_next.associated[i] = birth_particles.associated[birth_idx];
         }
         
@@ -57,5 +215,99 @@ void resample(const ParticlesSoA& particles, ParticlesSoA& particles_next,
     }
 }
 
+void resample(const ParticlesSoA& particles, CompactParticlesSoA& particles_next,
+              const ParticlesSoA& birth_particles,
+              const std::vector<float>& weight_array,
+              const std::vector<float>& birth_weight_array,
+              const RandomGenerator& rng, const DOGM::Params& params,
+              const GridWindow& window, ResamplingWorkspace& workspace) {
+
+    const int persistent_count = static_cast<int>(particles.size());
+    const int sample_count = static_cast<int>(particles_next.size());
+    float new_weight = 0.0f;
+
+    if (!selectJointAncestors(weight_array, birth_weight_array, sample_count, rng, params, workspace, new_weight)) {
+        kernel::initParticles(particles_next, rng, params.init_max_velocity, window);
+        return;
+    }
+
+    // resampling 뒤 가중치는 모두 같으므로 log2는 한 번만 계산한다
+    const int16_t log_weight = encodeLogWeight(new_weight);
+    const int* ancestors = workspace.ancestors.data();
+
+    // 조상 상태를 블록 단위로 스택에 모은 뒤 부호화 루프를 벡터화한다
+    constexpr int kBlockSize = 256;
+    const int block_count = (sample_count + kBlockSize - 1) / kBlockSize;
+
+    #pragma omp parallel for schedule(static)
+    for (int blk = 0; blk < block_count; ++blk) {
+        alignas(64) float x[kBlockSize];
+        alignas(64) float y[kBlockSize];
+        alignas(64) float vx[kBlockSize];
+        alignas(64) float vy[kBlockSize];
+        const int first = blk * kBlockSize;
+        const int n = std::min(kBlockSize, sample_count - first);
+
+        for (int k = 0; k < n; ++k) {
+            const int idx = ancestors[first + k];
+            const ParticlesSoA& src = idx < persistent_count ? particles : birth_particles;
+            const int src_idx = idx < persistent_count ? idx : idx - persistent_count;
+            x[k] = src.x[src_idx];
+            y[k] = src.y[src_idx];
+            vx[k] = src.vx[src_idx];
+            vy[k] = src.vy[src_idx];
+        }
+
+        int16_t* cell_x = particles_next.cell_x.data() + first;
+        int16_t* cell_y = particles_next.cell_y.data() + first;
+        uint16_t* offset_x = particles_next.offset_x.data() + first;
+        uint16_t* offset_y = particles_next.offset_y.data() + first;
+        uint16_t* half_vx = particles_next.vx.data() + first;
+        uint16_t* half_vy = particles_next.vy.data() + first;
+        int16_t* log_weights = particles_next.log_weight.data() + first;
+
+        #pragma omp simd
+        for (int k = 0; k < n; ++k) {
+            encodePosition(x[k], cell_x[k], offset_x[k]);
+            encodePosition(y[k], cell_y[k], offset_y[k]);
+            half_vx[k] = floatToHalf(vx[k]);
+            half_vy[k] = floatToHalf(vy[k]);
+            log_weights[k] = log_weight;
+        }
+    }
+}
+
+int chooseParticleCount(const DOGM::Params& params, const ParticleCountInputs& inputs) {
+    const int current = std::max(inputs.current_count, 1);
+    double target = current;
+
+    switch (params.particle_count_criterion) {
+    case ParticleCountCriterion::EffectiveSampleSize: {
+        // ESS 비율이 목표보다 낮으면(가중치 퇴화) 파티클을 늘리고, 높으면 줄인다.
+        double ratio = inputs.joint_count > 0 ? inputs.effective_sample_size / inputs.joint_count : 1.0;
+        target = current * params.target_ess_ratio / std::max(ratio, 1e-3);
+        break;
+    }
+    case ParticleCountCriterion::OccupiedCells:
+        target = static_cast<double>(inputs.occupied_cells) * params.particles_per_occupied_cell;
+        break;
+    case ParticleCountCriterion::KLD: {
+        // n = (k - 1) / (2 eps) * (1 - 2 / (9 (k - 1)) + sqrt(2 / (9 (k - 1))) z)^3
+        const int k = inputs.support_cells;
+        if (k > 1) {
+            const double a = 2.0 / (9.0 * (k - 1));
+            const double b = 1.0 - a + std::sqrt(a) * params.kld_z;
+            target = (k - 1) / (2.0 * params.kld_epsilon) * b * b * b;
+        } else {
+            target = params.min_particle_count;
+        }
+        break;
+    }
+    }
+
+    double next = current + params.particle_count_smoothing * (target - current);
+    return clamp(static_cast<int>(std::lround(next)), params.min_particle_count, params.max_particle_count);
+}
+
 } // namespace kernel
 } // namespace dogm
@@ -1,4 +1,5 @@
 #include "dogm/kernel/sensor_fusion.h"
+#include "dogm/kernel/ray_casting.h"
 #include <cmath>
 #include <algorithm>
 #include <vector>
@@ -14,83 +15,163 @@ float snrToConfidence(float snr, float min_snr = 5.0f, float max_snr = 20.0f) {
     return (snr - min_snr) / (max_snr - min_snr);
 }
 
+void RadarWorkspace::configure(int new_radius, float sigma) {
+    radius = std::max(new_radius, 0);
+    const int width = 2 * radius + 1;
+    footprint.resize(static_cast<size_t>(width) * width);
+    const float inv_two_sigma_sq = 1.0f / (2.0f * sigma * sigma);
+    for (int y = -radius; y <= radius; ++y) {
+        for (int x = -radius; x <= radius; ++x) {
+            footprint[(y + radius) * width + (x + radius)] = std::exp(-(x * x + y * y) * inv_two_sigma_sq);
+        }
+    }
+}
+
+void RadarWorkspace::reserve(int cell_count) {
+    if (accum.size() == static_cast<size_t>(cell_count)) return;
+    accum.assign(cell_count, CellAccum());
+    cells.clear();
+    cells.reserve(cell_count);
+}
+
+MeasurementCell unknownMeasurementCell() {
+    MeasurementCell cell;
+    cell.likelihood = 1.0f;
+    cell.p_A = 0.5f;
+    return cell;
+}
+
 void fuseAndCreateMeasurementGrid(std::vector<MeasurementCell>& meas_cells,
-                                 const SensorFrame& frame,
-                                 int grid_size, float resolution,
-                                 const Vec2& ego_pose, float ego_yaw) {
+                                 const SensorFrameView& frame,
+                                 const GridWindow& window,
+                                 const Vec2& ego_pose, float ego_yaw,
+                                 RayCastWorkspace& rays,
+                                 RadarWorkspace& radar,
+                                 ActiveCells& measured) {
     
-    // 1. 측정 그리드를 비어있는 상태(Unknown)로 초기화
-    std::fill(meas_cells.begin(), meas_cells.end(), MeasurementCell());
-
-    // 2. Lidar 데이터 처리: Inverse Sensor Model 적용 (간략화된 버전)
-    // 각 Lidar 측정치에 대해 광선을 따라가며 Free-space와 Occupied를 계산
-    for (size_t i = 0; i < frame.lidar.ranges.size(); ++i) {
-        float angle = frame.lidar.angles[i];
-        float range = frame.lidar.ranges[i];
-        
-        // 로봇 좌표계 기준 측정된 끝점
-        float end_x = range * std::cos(angle);
-        float end_y = range * std::sin(angle);
-
-        // 광선을 따라 그리드 셀을 업데이트
-        for (float r = 0; r < range; r += resolution) {
-            float x = r * std::cos(angle);
-            float y = r * std::sin(angle);
-            int grid_x = static_cast<int>((ego_pose.x() + x) / resolution);
-            int grid_y = static_cast<int>((ego_pose.y() + y) / resolution);
-
-            if (grid_x < 0 || grid_x >= grid_size || grid_y < 0 || grid_y >= grid_size) continue;
-            int idx = grid_y * grid_size + grid_x;
-            
-            // 다른 측정에 의해 점유된 셀은 덮어쓰지 않고, 비어있을 확률만 높임
-            meas_cells[idx].free_mass = std::max(meas_cells[idx].free_mass, 0.7f);
-            meas_cells[idx].occ_mass *= 0.5f; // free일 확률이 높으므로 occ 확률은 감소
+    const int grid_size = window.grid_size;
+    const float resolution = window.resolution;
+    const Vec2 window_origin = window.originMeters();
+    const MeasurementCell unknown = unknownMeasurementCell();
+
+    // 0. 이전 프레임에 측정이 있던 셀만 Unknown으로 되돌린다 (첫 호출은 전체 초기화)
+    if (measured.bits.size() != (meas_cells.size() + 63) / 64) {
+        measured.resize(meas_cells.size());
+        std::fill(meas_cells.begin(), meas_cells.end(), unknown);
+    } else {
+        for (int cell : measured.list) meas_cells[cell] = unknown;
+        measured.clear();
+    }
+
+    // 1. Lidar 데이터 처리: Inverse Sensor Model
+    // 빔이 통과한 셀은 free, 끝점 셀은 occupied. 끝점 라벨이 통과 라벨보다 우선한다.
+    // ray casting은 창 기준 로컬 좌표에서 수행하고, 라벨도 로컬 배치로 나온다.
+    castLidarRays(frame.lidar_ranges, frame.lidar_angles, frame.lidar_count, grid_size, resolution,
+                  ego_pose - window_origin, rays);
+
+    // 2. Lidar 결과 반영 (로컬 셀 -> ring buffer 저장 위치). 빔이 지나간 셀만 방문한다.
+    for (int local : rays.touched.list) {
+        const uint8_t label = rays.labels[local];
+        const int idx = window.physicalIndex(local % grid_size, local / grid_size);
+        MeasurementCell& cell = meas_cells[idx];
+        if (label & RAY_CELL_OCCUPIED) {
+            cell.occ_mass = 0.8f;
+            cell.free_mass = 0.0f;
+        } else if (label & RAY_CELL_FREE) {
+            cell.free_mass = 0.7f;
         }
-        
-        // 끝점은 점유 상태로 업데이트
-        int grid_x = static_cast<int>((ego_pose.x() + end_x) / resolution);
-        int grid_y = static_cast<int>((ego_pose.y() + end_y) / resolution);
-        if (grid_x < 0 || grid_x >= grid_size || grid_y < 0 || grid_y >= grid_size) continue;
-        int idx = grid_y * grid_size + grid_x;
-        meas_cells[idx].occ_mass = std::max(meas_cells[idx].occ_mass, 0.8f);
-        meas_cells[idx].free_mass = 0.0f; // 점유되었으므로 free일 확률은 0
+        measured.set(idx);
     }
 
-    // 3. Radar 데이터 처리 및 퓨전
-    for (const auto& detection : frame.radar) {
-        int grid_x = static_cast<int>(detection.position.x() / resolution);
-        int grid_y = static_cast<int>(detection.position.y() / resolution);
+    // 3. Radar 데이터 처리 및 퓨전: 검출마다 footprint 안의 셀에 SNR 신뢰도 * footprint 가중치로 기록
+    radar.reserve(static_cast<int>(meas_cells.size()));
+    const int radius = radar.footprint.empty() ? 0 : radar.radius;
+    const int width = 2 * radius + 1;
+    for (size_t d = 0; d < frame.radar_count; ++d) {
+        int grid_x = static_cast<int>((frame.radarX(d) - window_origin.x()) / resolution);
+        int grid_y = static_cast<int>((frame.radarY(d) - window_origin.y()) / resolution);
 
         if (grid_x < 0 || grid_x >= grid_size || grid_y < 0 || grid_y >= grid_size) continue;
-        
-        int idx = grid_y * grid_size + grid_x;
 
         // SNR을 이용해 점유 확률과 속도 신뢰도를 계산
-        float confidence = snrToConfidence(detection.snr);
-        
-        // Radar 탐지 지점은 점유 확률을 높임 (기존 Lidar 정보와 max 연산)
-        meas_cells[idx].occ_mass = std::max(meas_cells[idx].occ_mass, 0.7f * confidence);
-        meas_cells[idx].free_mass *= (1.0f - confidence); // Radar 탐지 지점의 free_mass 감소
-        
-        // 속도 정보 업데이트 (더 높은 신뢰도의 측정값으로 갱신)
-        if (confidence > meas_cells[idx].velocity_confidence) {
-             meas_cells[idx].radial_velocity = detection.radial_velocity;
-             meas_cells[idx].velocity_confidence = confidence;
+        const float confidence = snrToConfidence(frame.radarSnr(d));
+        if (confidence <= 0.0f) {
+            // 신뢰도가 없는 검출은 측정 셀로만 표시 (점유/속도 정보 없음)
+            measured.set(window.physicalIndex(grid_x, grid_y));
+            continue;
         }
+
+        // ego -> 검출 시선 단위 벡터 (검출당 sqrt 한 번)
+        Vec2 los(frame.radarX(d) - ego_pose.x(), frame.radarY(d) - ego_pose.y());
+        const float range = los.norm();
+        los = (range > 1e-6f) ? Vec2(los / range) : Vec2::Zero();
+        const float velocity = frame.radarVelocity(d);
+
+        for (int oy = -radius; oy <= radius; ++oy) {
+            const int y = grid_y + oy;
+            if (y < 0 || y >= grid_size) continue;
+            for (int ox = -radius; ox <= radius; ++ox) {
+                const int x = grid_x + ox;
+                if (x < 0 || x >= grid_size) continue;
+
+                const float w = radius == 0 ? confidence
+                                            : confidence * radar.footprint[(oy + radius) * width + (ox + radius)];
+                const int idx = window.physicalIndex(x, y);
+                measured.set(idx);
+
+                // Radar 탐지 지점은 점유 확률을 높임 (기존 Lidar 정보와 max 연산), free_mass는 감소
+                MeasurementCell& cell = meas_cells[idx];
+                cell.occ_mass = std::max(cell.occ_mass, 0.7f * w);
+                cell.free_mass *= (1.0f - w);
+                cell.velocity_confidence = std::max(cell.velocity_confidence, w);
+
+                RadarWorkspace::CellAccum& accum = radar.accum[idx];
+                if (accum.weight == 0.0f) radar.cells.push_back(idx);
+                accum.weight += w;
+                accum.velocity += w * velocity;
+                accum.velocity_sq += w * velocity * velocity;
+                accum.los_x += w * los.x();
+                accum.los_y += w * los.y();
+            }
+        }
+    }
+
+    // 셀별 SNR 가중 radial velocity 평균/분산과 시선 방향. 검출 간 속도가 엇갈릴수록 분산이 커져
+    // Doppler likelihood가 완만해진다.
+    for (int idx : radar.cells) {
+        RadarWorkspace::CellAccum& accum = radar.accum[idx];
+        MeasurementCell& cell = meas_cells[idx];
+        const float inv_weight = 1.0f / accum.weight;
+        const float mean = accum.velocity * inv_weight;
+        const float spread = std::max(accum.velocity_sq * inv_weight - mean * mean, 0.0f);
+        // SNR 기반 측정 잡음 (신뢰도 높을수록 오차에 민감)
+        const float stddev = 0.5f * (1.0f - cell.velocity_confidence * 0.8f);
+        cell.radial_velocity = mean;
+        cell.radial_velocity_var = stddev * stddev + spread;
+
+        const float los_norm = std::sqrt(accum.los_x * accum.los_x + accum.los_y * accum.los_y);
+        cell.los_x = (los_norm > 1e-6f) ? accum.los_x / los_norm : 0.0f;
+        cell.los_y = (los_norm > 1e-6f) ? accum.los_y / los_norm : 0.0f;
+        accum = RadarWorkspace::CellAccum();
     }
+    radar.cells.clear();
+    measured.buildList();
     
-    // 4. 모든 셀에 대해 확률 정규화 및 likelihood, p_A 설정
+    // 4. 측정이 있는 셀에 대해 확률 정규화 및 likelihood, p_A 설정
+    //    (측정이 없는 셀은 이미 unknownMeasurementCell() 값이다)
+    const int measured_count = static_cast<int>(measured.list.size());
     #pragma omp parallel for
-    for (size_t i = 0; i < meas_cells.size(); ++i) {
-        float total_mass = meas_cells[i].occ_mass + meas_cells[i].free_mass;
+    for (int k = 0; k < measured_count; ++k) {
+        MeasurementCell& cell = meas_cells[measured.list[k]];
+        float total_mass = cell.occ_mass + cell.free_mass;
         if (total_mass > 1.0f) { // 확률의 합이 1을 넘지 않도록 정규화
-            meas_cells[i].occ_mass /= total_mass;
-            meas_cells[i].free_mass /= total_mass;
+            cell.occ_mass /= total_mass;
+            cell.free_mass /= total_mass;
         }
         // likelihood는 기본값 1.0 사용
-        meas_cells[i].likelihood = 1.0f; 
+        cell.likelihood = 1.0f; 
         // 속도 신뢰도가 높을수록 연관 확률(p_A)을 높게 설정
-        meas_cells[i].p_A = 0.5f + 0.4f * meas_cells[i].velocity_confidence; 
+        cell.p_A = 0.5f + 0.4f * cell.velocity_confidence; 
     }
 }
 
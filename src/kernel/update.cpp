@@ -2,57 +2,142 @@
 #include <algorithm>
 #include <vector>
 #include "dogm/common.h" // accumulate, subtract를 위해 추가
+#include "dogm/fast_math.h"
+#include "dogm/particle_codec.h"
 
 namespace dogm {
 namespace kernel {
 
-void particleToGrid(const ParticlesSoA& particles, std::vector<GridCell>& grid_cells,
-                    std::vector<float>& weight_array) {
+namespace {
 
-    // ... (이하 기존 코드와 동일) ...
-    // Create a vector of indices to sort
-    std::vector<int> p_indices(particles.size());
-    std::iota(p_indices.begin(), p_indices.end(), 0);
+// Stable counting sort by cell_of(i):
+// (1) 스레드별 히스토그램 (2) 셀 단위 prefix sum (3) 스레드별 scatter (emit(i, dst))
+template<typename CellOf, typename Emit>
+void particleToGridImpl(int particle_count, CellOf cell_of, Emit emit, std::vector<GridCell>& grid_cells,
+                        std::vector<int>& cell_histogram, ActiveCells& occupied) {
+    const int cell_count = static_cast<int>(grid_cells.size());
+    const int max_threads = omp_get_max_threads();
 
-    // Sort indices based on particle's grid_cell_idx
-    std::sort(p_indices.begin(), p_indices.end(),
-        [&](int a, int b) {
-            return particles.grid_cell_idx[a] < particles.grid_cell_idx[b];
-        });
+    // 스레드별 히스토그램 max_threads 행 + 셀 시작 오프셋 1행
+    cell_histogram.resize(static_cast<size_t>(max_threads + 1) * cell_count);
+    int* cell_offsets = &cell_histogram[static_cast<size_t>(max_threads) * cell_count];
 
-    // Create sorted temporary particle storage
-    ParticlesSoA sorted_particles;
-    sorted_particles.resize(particles.size());
-    #pragma omp parallel for
-    for(size_t i = 0; i < particles.size(); ++i) {
-        sorted_particles.state[i] = particles.state[p_indices[i]];
-        sorted_particles.grid_cell_idx[i] = particles.grid_cell_idx[p_indices[i]];
-        sorted_particles.weight[i] = particles.weight[p_indices[i]];
-    }
-    // Now use the sorted particles
-    const_cast<ParticlesSoA&>(particles) = sorted_particles;
-    
-    #pragma omp parallel for
-    for(size_t i = 0; i < grid_cells.size(); ++i) {
-        grid_cells[i].start_idx = -1;
-        grid_cells[i].end_idx = -1;
+    // 이전 프레임에 파티클이 있던 셀만 빈 구간으로 되돌린다. 나머지 셀은 이미 -1이다.
+    if (occupied.bits.size() != (static_cast<size_t>(cell_count) + 63) / 64) {
+        occupied.resize(cell_count);
+        for (auto& cell : grid_cells) cell.start_idx = cell.end_idx = -1;
+    } else {
+        for (int c : occupied.list) grid_cells[c].start_idx = grid_cells[c].end_idx = -1;
+        occupied.clear();
     }
 
-    if (particles.size() == 0) return;
+    #pragma omp parallel
+    {
+        const int num_threads = omp_get_num_threads();
+        const int tid = omp_get_thread_num();
+        const int begin = static_cast<int>(static_cast<long long>(particle_count) * tid / num_threads);
+        const int end = static_cast<int>(static_cast<long long>(particle_count) * (tid + 1) / num_threads);
+        int* hist = &cell_histogram[static_cast<size_t>(tid) * cell_count];
 
-    // This part now needs to be careful due to sorting
-    grid_cells[particles.grid_cell_idx[0]].start_idx = 0;
-    for (size_t i = 1; i < particles.size(); ++i) {
-        weight_array[i-1] = particles.weight[i-1];
-        int prev_cell_idx = particles.grid_cell_idx[i-1];
-        int cell_idx = particles.grid_cell_idx[i];
-        if (cell_idx != prev_cell_idx) {
-            grid_cells[prev_cell_idx].end_idx = i - 1;
-            grid_cells[cell_idx].start_idx = i;
+        std::fill(hist, hist + cell_count, 0);
+        for (int i = begin; i < end; ++i) {
+            ++hist[cell_of(i)];
+        }
+        #pragma omp barrier
+
+        // 셀별 파티클 수
+        #pragma omp for
+        for (int c = 0; c < cell_count; ++c) {
+            int total = 0;
+            for (int t = 0; t < num_threads; ++t) {
+                total += cell_histogram[static_cast<size_t>(t) * cell_count + c];
+            }
+            cell_offsets[c] = total;
+        }
+
+        #pragma omp single
+        {
+            int running = 0;
+            for (int c = 0; c < cell_count; ++c) {
+                int count = cell_offsets[c];
+                cell_offsets[c] = running;
+                running += count;
+            }
+        }
+
+        // 히스토그램으로부터 start_idx/end_idx를 바로 기록하고, 스레드별 scatter 위치로 변환.
+        // 청크를 64셀(bitmap word 하나) 단위로 나눠 occupied.set이 word를 공유하지 않게 한다.
+        #pragma omp for schedule(static, 64)
+        for (int c = 0; c < cell_count; ++c) {
+            int running = cell_offsets[c];
+            for (int t = 0; t < num_threads; ++t) {
+                int& slot = cell_histogram[static_cast<size_t>(t) * cell_count + c];
+                int count = slot;
+                slot = running;
+                running += count;
+            }
+            if (running > cell_offsets[c]) {
+                grid_cells[c].start_idx = cell_offsets[c];
+                grid_cells[c].end_idx = running - 1;
+                occupied.set(c);
+            }
+        }
+
+        // 같은 셀 안에서는 원래 순서를 유지 (stable)
+        for (int i = begin; i < end; ++i) {
+            emit(i, hist[cell_of(i)]++);
         }
     }
-    grid_cells[particles.grid_cell_idx.back()].end_idx = particles.size() - 1;
-    weight_array.back() = particles.weight.back();
+    occupied.buildList();
+}
+
+} // namespace
+
+void particleToGrid(const ParticlesSoA& particles, ParticlesSoA& sorted_particles,
+                    std::vector<GridCell>& grid_cells, std::vector<float>& weight_array,
+                    std::vector<int>& cell_histogram, ActiveCells& occupied) {
+    sorted_particles.resize(particles.size());
+    const int* grid_cell_idx = particles.grid_cell_idx.data();
+    particleToGridImpl(static_cast<int>(particles.size()), [grid_cell_idx](int i) { return grid_cell_idx[i]; },
+        [&](int i, int dst) {
+            sorted_particles.copyStateFrom(dst, particles, i);
+            sorted_particles.grid_cell_idx[dst] = particles.grid_cell_idx[i];
+            sorted_particles.weight[dst] = particles.weight[i];
+            sorted_particles.associated[dst] = particles.associated[i];
+            weight_array[dst] = particles.weight[i];
+        }, grid_cells, cell_histogram, occupied);
+}
+
+void particleToGrid(const CompactParticlesSoA& particles, ParticlesSoA& sorted_particles,
+                    std::vector<GridCell>& grid_cells, std::vector<float>& weight_array,
+                    std::vector<int>& cell_histogram, std::vector<int>& particle_cells, ActiveCells& occupied,
+                    const GridWindow& window, float persistence) {
+    sorted_particles.resize(particles.size());
+    const int grid_size = window.grid_size;
+    const int count = static_cast<int>(particles.size());
+    const int16_t* cell_x = particles.cell_x.data();
+    const int16_t* cell_y = particles.cell_y.data();
+
+    // 셀 인덱스는 히스토그램과 scatter에서 두 번 쓰므로 한 번만 계산해 둔다
+    particle_cells.resize(particles.size());
+    int* cells = particle_cells.data();
+    #pragma omp parallel for
+    for (int i = 0; i < count; ++i) {
+        cells[i] = window.physicalIndex(clamp<int>(cell_x[i], 0, grid_size - 1), clamp<int>(cell_y[i], 0, grid_size - 1));
+    }
+
+    particleToGridImpl(count, [cells](int i) { return cells[i]; },
+        [&](int i, int dst) {
+            const bool inside = cell_x[i] >= 0 && cell_x[i] < grid_size && cell_y[i] >= 0 && cell_y[i] < grid_size;
+            const float weight = inside ? decodeLogWeight(particles.log_weight[i]) * persistence : 0.0f;
+            sorted_particles.setState(dst, decodePosition(cell_x[i], particles.offset_x[i]),
+                                      decodePosition(cell_y[i], particles.offset_y[i]),
+                                      halfToFloat(particles.vx[i]), halfToFloat(particles.vy[i]));
+            sorted_particles.grid_cell_idx[dst] = cells[i];
+            sorted_particles.weight[dst] = weight;
+            sorted_particles.associated[dst] = false;
+            weight_array[dst] = weight;
+        }, grid_cells, cell_histogram, occupied);
 }
 
 
@@ -63,22 +148,23 @@ void updateOccupancy(std::vector<GridCell>& grid_cells,
                      std::vector<float>& born_masses_array,
                      const DOGM::Params& params, float dt) {
 
-    std::vector<float> weight_accum;
-    accumulate(weight_array, weight_accum);
+    const float freespace_discount_factor = std::pow(params.freespace_discount, dt);
 
     #pragma omp parallel for
     for (size_t i = 0; i < grid_cells.size(); ++i) {
         auto& cell = grid_cells[i];
         const auto& meas_cell = meas_cells[i];
 
+        // 셀의 파티클 구간 합. 전역 prefix sum의 차보다 정확하고 updateCellsFused와 같은 순서로 더한다.
         float m_occ_pred = 0.0f;
         if (cell.start_idx != -1) {
-            m_occ_pred = subtract(weight_accum, cell.start_idx, cell.end_idx);
+            for (int p = cell.start_idx; p <= cell.end_idx; ++p) {
+                m_occ_pred += weight_array[p];
+            }
         }
         
         m_occ_pred = clamp(m_occ_pred, 0.0f, 1.0f);
         
-        float freespace_discount_factor = std::pow(params.freespace_discount, dt);
         float m_free_pred = std::min(freespace_discount_factor * cell.free_mass, 1.0f - m_occ_pred);
 
         // Dempster-Shafer combination
@@ -102,10 +188,8 @@ void updateOccupancy(std::vector<GridCell>& grid_cells,
     }
 }
 
-// 'const Vec2& ego_pose' 인자 추가
 void updatePersistent(ParticlesSoA& particles, const std::vector<MeasurementCell>& meas_cells,
-                      std::vector<GridCell>& grid_cells, std::vector<float>& weight_array,
-                      const Vec2& ego_pose) {
+                      std::vector<GridCell>& grid_cells, std::vector<float>& weight_array) {
     
     // Kernel 1: Update unnormalized weights
     #pragma omp parallel for
@@ -114,15 +198,15 @@ void updatePersistent(ParticlesSoA& particles, const std::vector<MeasurementCell
         weight_array[i] = meas_cells[cell_idx].likelihood * particles.weight[i];
     }
     
-    std::vector<float> weight_accum;
-    accumulate(weight_array, weight_accum);
-
     // Kernel 2: Calculate normalization components
     #pragma omp parallel for
     for(size_t i = 0; i < grid_cells.size(); ++i) {
         auto& cell = grid_cells[i];
         if(cell.start_idx != -1) {
-            float m_occ_accum = subtract(weight_accum, cell.start_idx, cell.end_idx);
+            float m_occ_accum = 0.0f;
+            for (int p = cell.start_idx; p <= cell.end_idx; ++p) {
+                m_occ_accum += weight_array[p];
+            }
             cell.mu_A = (m_occ_accum > 0.0f) ? cell.pers_occ_mass / m_occ_accum : 0.0f;
             cell.mu_UA = (cell.pred_occ_mass > 0.0f) ? cell.pers_occ_mass / cell.pred_occ_mass : 0.0f;
         } else {
@@ -140,35 +224,26 @@ void updatePersistent(ParticlesSoA& particles, const std::vector<MeasurementCell
         
         float new_weight = meas_cell.p_A * cell.mu_A * weight_array[i] + (1.0f - meas_cell.p_A) * cell.mu_UA * particles.weight[i];
         
-        // Add velocity likelihood for radar fusion
+        // Add velocity likelihood for radar fusion: 셀에 캐시된 시선 벡터로 radial velocity를 내적 하나로
         if(meas_cell.velocity_confidence > 0.5f) {
-            // [BUG FIX] 하드코딩된 값(1.5f) 대신 실제 로봇의 위치(ego_pose) 사용
-            float dx = particles.state[i][0] - ego_pose.x();
-            float dy = particles.state[i][1] - ego_pose.y();
-            float angle = std::atan2(dy, dx);
-            float particle_radial_vel = particles.state[i][2] * cos(angle) + particles.state[i][3] * sin(angle);
-            float vel_diff = particle_radial_vel - meas_cell.radial_velocity;
-            
-            // SNR 기반으로 속도 측정 노이즈 조절 (신뢰도 높을수록 오차에 민감)
-            float stddev = 0.5f * (1.0f - meas_cell.velocity_confidence * 0.8f);
-            float vel_likelihood = exp(-0.5f * vel_diff * vel_diff / (stddev * stddev));
-            new_weight *= vel_likelihood;
+            new_weight *= dopplerLikelihood(particles.vx[i], particles.vy[i], meas_cell.los_x, meas_cell.los_y,
+                                            meas_cell.radial_velocity, -0.5f / meas_cell.radial_velocity_var);
         }
         
         weight_array[i] = new_weight;
     }
 }
 
-void computeStatisticalMoments(const ParticlesSoA& particles, std::vector<GridCell>& grid_cells,
-                               const std::vector<float>& weight_array) {
+void computeStatisticalMoments(const ParticlesSoA& particles, const std::vector<GridCell>& grid_cells,
+                               std::vector<GridCellMoments>& grid_moments, const std::vector<float>& weight_array) {
     
     #pragma omp parallel for
     for (size_t i = 0; i < grid_cells.size(); ++i) {
-        auto& cell = grid_cells[i];
+        const auto& cell = grid_cells[i];
+        auto& moments = grid_moments[i];
         
         if (cell.start_idx == -1 || cell.pers_occ_mass == 0.0f) {
-            cell.mean_x_vel = cell.mean_y_vel = 0.0f;
-            cell.var_x_vel = cell.var_y_vel = cell.covar_xy_vel = 0.0f;
+            moments = GridCellMoments();
             continue;
         }
         
@@ -178,8 +253,8 @@ void computeStatisticalMoments(const ParticlesSoA& particles, std::vector<GridCe
         
         for (int p_idx = cell.start_idx; p_idx <= cell.end_idx; ++p_idx) {
             float w = weight_array[p_idx];
-            float vx = particles.state[p_idx][2];
-            float vy = particles.state[p_idx][3];
+            float vx = particles.vx[p_idx];
+            float vy = particles.vy[p_idx];
             
             sum_vx += w * vx;
             sum_vy += w * vy;
@@ -195,13 +270,175 @@ void computeStatisticalMoments(const ParticlesSoA& particles, std::vector<GridCe
         float mean_x = inv_rho * sum_vx;
         float mean_y = inv_rho * sum_vy;
         
-        cell.mean_x_vel = mean_x;
-        cell.mean_y_vel = mean_y;
-        cell.var_x_vel = inv_rho * sum_vx2 - mean_x * mean_x;
-        cell.var_y_vel = inv_rho * sum_vy2 - mean_y * mean_y;
-        cell.covar_xy_vel = inv_rho * sum_vxy - mean_x * mean_y;
+        moments.mean_x_vel = mean_x;
+        moments.mean_y_vel = mean_y;
+        moments.var_x_vel = inv_rho * sum_vx2 - mean_x * mean_x;
+        moments.var_y_vel = inv_rho * sum_vy2 - mean_y * mean_y;
+        moments.covar_xy_vel = inv_rho * sum_vxy - mean_x * mean_y;
+    }
+}
+
+namespace {
+
+// updateCellsFused의 본체. cell_at(k)가 k번째로 처리할 셀 인덱스를 돌려주고, born_masses_array는 k로 쓴다.
+// Sparse면 처리 전에 밀린 decay를 적용하고 셀을 clock.current로 표시한다.
+template<bool Sparse, typename CellAt>
+void updateCellsFusedImpl(int count, CellAt cell_at, std::vector<GridCell>& grid_cells,
+                          std::vector<GridCellMoments>& grid_moments, const ParticlesSoA& particles,
+                          std::vector<float>& weight_array, const std::vector<MeasurementCell>& meas_cells, std::vector<float>& born_masses_array,
+                          const DOGM::Params& params, float dt, const CellClock& clock) {
+
+    const float freespace_discount_factor = std::pow(params.freespace_discount, dt);
+
+    // 셀마다 파티클 수가 크게 달라 dynamic으로 분배
+    #pragma omp parallel for schedule(dynamic, 256)
+    for (int k = 0; k < count; ++k) {
+        const int i = cell_at(k);
+        auto& cell = grid_cells[i];
+        auto& moments = grid_moments[i];
+        const auto& meas_cell = meas_cells[i];
+        const bool has_particles = cell.start_idx != -1;
+        if (Sparse) {
+            applyPendingDecay(cell, moments, clock.previous, params.freespace_discount);
+            cell.last_update_time = clock.current;
+        }
+
+        // --- Occupancy update (updateOccupancy) ---
+        float m_occ_pred = 0.0f;
+        float m_lik_accum = 0.0f;
+        if (has_particles) {
+            for (int p = cell.start_idx; p <= cell.end_idx; ++p) {
+                m_occ_pred += weight_array[p];
+                m_lik_accum += meas_cell.likelihood * weight_array[p];
+            }
+        }
+
+        m_occ_pred = clamp(m_occ_pred, 0.0f, 1.0f);
+        float m_free_pred = std::min(freespace_discount_factor * cell.free_mass, 1.0f - m_occ_pred);
+
+        // Dempster-Shafer combination
+        float unknown_pred = 1.0f - m_occ_pred - m_free_pred;
+        float meas_unknown = 1.0f - meas_cell.free_mass - meas_cell.occ_mass;
+        float K = m_free_pred * meas_cell.occ_mass + m_occ_pred * meas_cell.free_mass;
+
+        float m_occ_up = (m_occ_pred * meas_unknown + unknown_pred * meas_cell.occ_mass + m_occ_pred * meas_cell.occ_mass) / (1.0f - K);
+        float m_free_up = (m_free_pred * meas_unknown + unknown_pred * meas_cell.free_mass + m_free_pred * meas_cell.free_mass) / (1.0f - K);
+
+        float rho_b = (m_occ_up * params.birth_prob * (1.0f - m_occ_pred)) / (m_occ_pred + params.birth_prob * (1.0f - m_occ_pred) + 1e-9);
+        float rho_p = m_occ_up - rho_b;
+
+        born_masses_array[k] = clamp(rho_b, 0.0f, 1.0f);
+
+        cell.pers_occ_mass = clamp(rho_p, 0.0f, 1.0f);
+        cell.new_born_occ_mass = clamp(rho_b, 0.0f, 1.0f);
+        cell.free_mass = clamp(m_free_up, 0.0f, 1.0f);
+        cell.occ_mass = clamp(m_occ_up, 0.0f, 1.0f);
+        cell.pred_occ_mass = m_occ_pred;
+
+        if (!has_particles) {
+            cell.mu_A = cell.mu_UA = 0.0f;
+            moments = GridCellMoments();
+            continue;
+        }
+
+        // --- Persistent weights (updatePersistent) ---
+        cell.mu_A = (m_lik_accum > 0.0f) ? cell.pers_occ_mass / m_lik_accum : 0.0f;
+        cell.mu_UA = (cell.pred_occ_mass > 0.0f) ? cell.pers_occ_mass / cell.pred_occ_mass : 0.0f;
+
+        const float a_coeff = meas_cell.p_A * cell.mu_A;
+        const float ua_coeff = (1.0f - meas_cell.p_A) * cell.mu_UA;
+        const float likelihood = meas_cell.likelihood;
+
+        // 새 가중치는 파티클끼리 독립이므로 벡터화되는 루프로 먼저 계산한다 (Radar 셀은 Doppler likelihood 포함)
+        float* weights = weight_array.data();
+        const float* particle_vx = particles.vx.data();
+        const float* particle_vy = particles.vy.data();
+        if (meas_cell.velocity_confidence > 0.5f) {
+            const float los_x = meas_cell.los_x;
+            const float los_y = meas_cell.los_y;
+            const float radial_velocity = meas_cell.radial_velocity;
+            const float neg_half_inv_var = -0.5f / meas_cell.radial_velocity_var;
+            #pragma omp simd
+            for (int p = cell.start_idx; p <= cell.end_idx; ++p) {
+                const float w = weights[p];
+                weights[p] = (a_coeff * (likelihood * w) + ua_coeff * w) *
+                             dopplerLikelihood(particle_vx[p], particle_vy[p], los_x, los_y, radial_velocity,
+                                               neg_half_inv_var);
+            }
+        } else {
+            #pragma omp simd
+            for (int p = cell.start_idx; p <= cell.end_idx; ++p) {
+                const float w = weights[p];
+                weights[p] = a_coeff * (likelihood * w) + ua_coeff * w;
+            }
+        }
+
+        // --- Statistical moments (computeStatisticalMoments), 새 가중치로 누적 ---
+        float sum_vx = 0.0f, sum_vy = 0.0f;
+        float sum_vx2 = 0.0f, sum_vy2 = 0.0f, sum_vxy = 0.0f;
+        float total_weight = 0.0f;
+
+        for (int p = cell.start_idx; p <= cell.end_idx; ++p) {
+            const float new_weight = weights[p];
+            const float vx = particle_vx[p];
+            const float vy = particle_vy[p];
+
+            sum_vx += new_weight * vx;
+            sum_vy += new_weight * vy;
+            sum_vx2 += new_weight * vx * vx;
+            sum_vy2 += new_weight * vy * vy;
+            sum_vxy += new_weight * vx * vy;
+            total_weight += new_weight;
+        }
+
+        if (cell.pers_occ_mass == 0.0f) {
+            moments = GridCellMoments();
+            continue;
+        }
+        if (total_weight < 1e-9) continue; // staged 경로와 같이 이전 값을 유지
+
+        float inv_rho = 1.0f / total_weight;
+        float mean_x = inv_rho * sum_vx;
+        float mean_y = inv_rho * sum_vy;
+
+        moments.mean_x_vel = mean_x;
+        moments.mean_y_vel = mean_y;
+        moments.var_x_vel = inv_rho * sum_vx2 - mean_x * mean_x;
+        moments.var_y_vel = inv_rho * sum_vy2 - mean_y * mean_y;
+        moments.covar_xy_vel = inv_rho * sum_vxy - mean_x * mean_y;
     }
 }
 
+} // namespace
+
+void applyPendingDecay(std::vector<GridCell>& grid_cells, std::vector<GridCellMoments>& grid_moments,
+                       double time, float freespace_discount) {
+    #pragma omp parallel for
+    for (size_t i = 0; i < grid_cells.size(); ++i) {
+        applyPendingDecay(grid_cells[i], grid_moments[i], time, freespace_discount);
+    }
+}
+
+void updateCellsFused(std::vector<GridCell>& grid_cells, std::vector<GridCellMoments>& grid_moments,
+                      const ParticlesSoA& particles,
+                      std::vector<float>& weight_array, const std::vector<MeasurementCell>& meas_cells,
+                      std::vector<float>& born_masses_array, const DOGM::Params& params, float dt) {
+    updateCellsFusedImpl<false>(static_cast<int>(grid_cells.size()), [](int k) { return k; },
+                                grid_cells, grid_moments, particles, weight_array, meas_cells, born_masses_array,
+                                params, dt, CellClock{});
+}
+
+void updateCellsFusedSparse(std::vector<GridCell>& grid_cells, std::vector<GridCellMoments>& grid_moments,
+                            const ActiveCells& active,
+                            const ParticlesSoA& particles, std::vector<float>& weight_array,
+                            const std::vector<MeasurementCell>& meas_cells, std::vector<float>& born_masses_array,
+                            const DOGM::Params& params, float dt, const CellClock& clock) {
+    const int* list = active.list.data();
+    born_masses_array.resize(active.list.size());
+    updateCellsFusedImpl<true>(static_cast<int>(active.list.size()), [list](int k) { return list[k]; },
+                               grid_cells, grid_moments, particles, weight_array, meas_cells, born_masses_array,
+                               params, dt, clock);
+}
+
 } // namespace kernel
 } // namespace dogm
\ No newline at end of file
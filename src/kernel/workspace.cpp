@@ -0,0 +1,43 @@
+#include "dogm/kernel/workspace.h"
+#include <algorithm>
+#include <cmath>
+
+namespace dogm {
+namespace kernel {
+
+size_t maxParticleCount(const DOGM::Params& params) {
+    if (!params.adaptive_particle_count) return static_cast<size_t>(params.particle_count);
+    return static_cast<size_t>(std::max(params.particle_count, params.max_particle_count));
+}
+
+// DOGM::initializeNewParticles의 신생 파티클 수 식에 최대 파티클 수를 넣은 값
+size_t maxBirthParticleCount(const DOGM::Params& params) {
+    if (!params.adaptive_particle_count) return static_cast<size_t>(params.new_born_particle_count);
+    const double ratio = static_cast<double>(params.new_born_particle_count) / params.particle_count;
+    const size_t scaled = static_cast<size_t>(std::lround(static_cast<double>(maxParticleCount(params)) * ratio));
+    return std::max<size_t>({1, scaled, static_cast<size_t>(params.new_born_particle_count)});
+}
+
+void reserveWorkspace(Workspace& workspace, const DOGM::Params& params, int grid_size, int cell_count,
+                      int threads) {
+    workspace.rays.reserve(grid_size * grid_size, threads);
+    workspace.radar.configure(params.radar_splat_radius, params.radar_splat_sigma);
+    workspace.radar.reserve(cell_count);
+
+    const size_t particle_capacity = maxParticleCount(params);
+    const size_t joint_capacity = particle_capacity + maxBirthParticleCount(params);
+    ResamplingWorkspace& resampling = workspace.resampling;
+    resampling.joint_weights.reserve(joint_capacity);
+    resampling.accum_weights.reserve(joint_capacity);
+    resampling.residual_accum.reserve(joint_capacity);
+    resampling.replication_offsets.reserve(joint_capacity);
+    resampling.ancestors.reserve(particle_capacity);
+
+    // sparse면 born_masses_array는 활성 셀 수만큼이므로 셀 수가 상한
+    workspace.birth.particle_orders_accum.reserve(cell_count);
+    workspace.cell_histogram.resize(static_cast<size_t>(threads + 1) * cell_count);
+    if (params.compact_particle_state) workspace.compact_cells.reserve(particle_capacity);
+}
+
+} // namespace kernel
+} // namespace dogm
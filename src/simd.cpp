@@ -0,0 +1,58 @@
+#include "dogm/simd.h"
+
+#include <cstdlib>
+#include <cstring>
+
+namespace dogm {
+
+namespace {
+
+bool cpuHasAVX2() {
+#if defined(DOGM_HAVE_AVX2_KERNELS) && (defined(__GNUC__) || defined(__clang__))
+    return __builtin_cpu_supports("avx2");
+#else
+    return false;
+#endif
+}
+
+bool cpuHasAVX512() {
+#if defined(DOGM_HAVE_AVX512_KERNELS) && (defined(__GNUC__) || defined(__clang__))
+    return __builtin_cpu_supports("avx512f");
+#else
+    return false;
+#endif
+}
+
+SimdLevel detectOnce() {
+    SimdLevel level = SimdLevel::Scalar;
+    if (cpuHasAVX2()) level = SimdLevel::AVX2;
+    if (cpuHasAVX512()) level = SimdLevel::AVX512;
+
+    // 비교/디버깅용 override. 지원하지 않는 수준을 요청하면 무시한다.
+    if (const char* env = std::getenv("DOGM_SIMD")) {
+        SimdLevel requested = level;
+        if (std::strcmp(env, "scalar") == 0) requested = SimdLevel::Scalar;
+        else if (std::strcmp(env, "avx2") == 0) requested = SimdLevel::AVX2;
+        else if (std::strcmp(env, "avx512") == 0) requested = SimdLevel::AVX512;
+        if (static_cast<int>(requested) < static_cast<int>(level)) level = requested;
+    }
+    return level;
+}
+
+} // namespace
+
+SimdLevel detectSimdLevel() {
+    static const SimdLevel level = detectOnce();
+    return level;
+}
+
+bool isSimdLevelSupported(SimdLevel level) {
+    switch (level) {
+    case SimdLevel::Scalar: return true;
+    case SimdLevel::AVX2:   return cpuHasAVX2();
+    case SimdLevel::AVX512: return cpuHasAVX512();
+    }
+    return false;
+}
+
+} // namespace dogm
@@ -0,0 +1,43 @@
+#include "dogm/stats.h"
+#include <algorithm>
+#include <cmath>
+
+namespace dogm {
+
+void RollingHistogram::resize(size_t window) {
+    samples.assign(window, 0.0);
+    next = 0;
+    filled = 0;
+}
+
+void RollingHistogram::add(double value) {
+    if (samples.empty()) return;
+    samples[next] = value;
+    next = (next + 1) % samples.size();
+    filled = std::min(filled + 1, samples.size());
+}
+
+double RollingHistogram::percentile(double p) const {
+    if (filled == 0) return 0.0;
+    std::vector<double> sorted(samples.begin(), samples.begin() + filled);
+    size_t rank = static_cast<size_t>(std::ceil(p / 100.0 * filled));
+    rank = std::min(std::max<size_t>(rank, 1), filled) - 1;
+    std::nth_element(sorted.begin(), sorted.begin() + rank, sorted.end());
+    return sorted[rank];
+}
+
+void LatencyHistogram::resize(size_t window) {
+    for (auto& stage : stages) {
+        stage.resize(window);
+    }
+    total.resize(window);
+}
+
+void LatencyHistogram::add(const DOGMStats& stats) {
+    for (int i = 0; i < kStageCount; ++i) {
+        stages[i].add(stats.stage_ms[i]);
+    }
+    total.add(stats.total_ms);
+}
+
+} // namespace dogm